@@ -0,0 +1,50 @@
+#ifndef HD_BASHBUILTIN_H
+#define HD_BASHBUILTIN_H
+
+/**
+ * The part of the bash loadable builtin interface used by hdbuiltin.cpp,
+ * declared here so the builtin builds without the bash development headers.
+ * These layouts are unchanged from bash 4.0 through 5.2, see builtins.h,
+ * command.h and variables.h in the bash sources.
+ */
+
+extern "C" {
+
+typedef struct word_desc {
+    char *word;
+    int flags;
+} WORD_DESC;
+
+typedef struct word_list {
+    struct word_list *next;
+    WORD_DESC *word;
+} WORD_LIST;
+
+typedef int sh_builtin_func_t(WORD_LIST *);
+
+#define BUILTIN_ENABLED 0x01
+
+struct builtin {
+    const char *name;
+    sh_builtin_func_t *function;
+    int flags;
+    const char *const *long_doc;
+    const char *short_doc;
+    char *handle;
+};
+
+#define EXECUTION_SUCCESS 0
+#define EXECUTION_FAILURE 1
+#define EX_USAGE 258
+
+typedef struct variable SHELL_VAR;
+
+// resolved from the running shell when the builtin is enabled
+SHELL_VAR *bind_variable(const char *name, char *value, int flags);
+int legal_identifier(const char *name);
+void builtin_error(const char *format, ...);
+void builtin_usage(void);
+
+}
+
+#endif // HD_BASHBUILTIN_H
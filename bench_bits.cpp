@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bits.hpp"
+#include "cpu.hpp"
+
+/**
+ * Bit deposit benchmark, times the base and the CPU's variants of pdep,
+ * pext and Morton codes over the same random words and checks they agree
+ *
+ *     bench_bits COUNT
+ */
+
+static double now_ns(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t xorshift(uint64_t *state) noexcept {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// each kernel once over count words, into a sum the compiler has to keep
+static double run(const BitKernels& k, int which, long count, uint64_t *sum) noexcept {
+    uint64_t state = 0x9E3779B97F4A7C15;
+    uint64_t acc = 0;
+    double start = now_ns();
+    for (long i = 0; i < count; i++) {
+        uint64_t a = xorshift(&state);
+        uint64_t b = xorshift(&state);
+        switch (which) {
+        case 0: acc += k.deposit(a, b); break;
+        case 1: acc += k.gather(a, b); break;
+        case 2: acc += k.spread2(a) | k.spread2(b) << 1; break;
+        case 3: acc += k.compact2(a) ^ k.compact2(a >> 1); break;
+        case 4: acc += k.spread3(a) | k.spread3(b) << 1; break;
+        case 5: acc += k.compact3(a) ^ k.compact3(a >> 1); break;
+        }
+    }
+    *sum = acc;
+    return (now_ns() - start) / count;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || atol(argv[1]) < 1) {
+        fprintf(stderr, "bench_bits COUNT\n");
+        return 1;
+    }
+    long count = atol(argv[1]);
+    static const char *names[] = {
+        "pdep", "pext", "interleave", "deinterleave", "interleave3", "deinterleave3",
+    };
+
+    BitKernels base = bits_kernels(0);
+    BitKernels best = bits_kernels(cpu_features());
+    cpu_print(stdout);
+    printf("%-16s %12s %12s\n", "ns per op", base.deposit_name, best.deposit_name);
+    int status = 0;
+    for (int i = 0; i < 6; i++) {
+        uint64_t base_sum, best_sum;
+        double base_ns = run(base, i, count, &base_sum);
+        double best_ns = run(best, i, count, &best_sum);
+        printf("%-16s %12.2f %12.2f\n", names[i], base_ns, best_ns);
+        if (base_sum != best_sum) {
+            fprintf(stderr, "%s: the variants disagree\n", names[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
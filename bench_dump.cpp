@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "cpu.hpp"
+#include "dump.hpp"
+
+/**
+ * Hexdump benchmark, the MB/s of the base and the CPU's variants of the
+ * lines of 'hd --dump' over a buffer of random bytes, at every group size
+ * in both orders, and checks they agree
+ *
+ *     bench_dump MB
+ */
+
+static double now_ns(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t xorshift(uint64_t *state) noexcept {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// the whole buffer in steps of 64 KiB as hd reads it, the last step's lines kept in out
+static double run(const DumpKernels& k, const DumpFormat& format, const std::vector<unsigned char>& data,
+        std::vector<char>& out) noexcept {
+    const size_t step = 1 << 16;
+    double start = now_ns();
+    for (size_t at = 0; at < data.size(); at += step) {
+        size_t size = data.size() - at < step ? data.size() - at : step;
+        size_t len = dump_lines(out.data(), &data[at], size, at, format, k);
+        out[len] = '\0';
+    }
+    return data.size() / ((now_ns() - start) / 1e3);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || atol(argv[1]) < 1) {
+        fprintf(stderr, "bench_dump MB\n");
+        return 1;
+    }
+    std::vector<unsigned char> data((size_t)atol(argv[1]) << 20 | 7); // and a partial line
+    uint64_t state = 0x9E3779B97F4A7C15;
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (unsigned char)xorshift(&state);
+    }
+    std::vector<char> base_out((1 << 16) / DUMP_LINE * DUMP_LINE_MAX + DUMP_LINE_MAX);
+    std::vector<char> best_out(base_out.size());
+
+    DumpKernels base = dump_kernels(0);
+    DumpKernels best = dump_kernels(cpu_features());
+    cpu_print(stdout);
+    printf("%-16s %12s %12s\n", "MB/s", base.name, best.name);
+    int status = 0;
+    for (unsigned group = 1; group <= 16; group *= 2) {
+        for (int little = 0; little < 2; little++) {
+            DumpFormat format = {group, little == 1, 8};
+            char name[32];
+            snprintf(name, sizeof(name), "%u %s", group, little ? "little" : "big");
+            double base_mbs = run(base, format, data, base_out);
+            double best_mbs = run(best, format, data, best_out);
+            printf("%-16s %12.0f %12.0f\n", name, base_mbs, best_mbs);
+            if (strcmp(base_out.data(), best_out.data()) != 0) {
+                fprintf(stderr, "%s: the variants disagree\n", name);
+                status = 1;
+            }
+        }
+    }
+    return status;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "cpu.hpp"
+#include "minifloat.hpp"
+
+/**
+ * Minifloat decoding benchmark, converts buffers of every 16 and 8 bit
+ * pattern to float32 many times over
+ *
+ *     bench_half ROUNDS
+ */
+
+static double now_ns(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double run(void (* decode)(const uint16_t *, float *, size_t), const std::vector<uint16_t>& src,
+        std::vector<float>& dst, long rounds) noexcept {
+    double start = now_ns();
+    for (long i = 0; i < rounds; i++) {
+        decode(src.data(), dst.data(), src.size());
+    }
+    return (now_ns() - start) / ((double)rounds * src.size());
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || atol(argv[1]) < 1) {
+        fprintf(stderr, "bench_half ROUNDS\n");
+        return 1;
+    }
+    long rounds = atol(argv[1]);
+
+    std::vector<uint16_t> src(65536);
+    std::vector<float> dst(src.size());
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = (uint16_t)i;
+    }
+
+    cpu_print(stdout);
+    printf("%-16s %.3f ns per value\n", "half:", run(half_to_float_n, src, dst, rounds));
+    printf("%-16s %.3f ns per value\n", "bfloat16:", run(bf16_to_float_n, src, dst, rounds));
+
+    // the same buffer's bytes, 2 values a pattern
+    std::vector<float> dst8(src.size() * 2);
+    const uint8_t *src8 = (const uint8_t *)src.data();
+    for (int e5m2 = 0; e5m2 < 2; e5m2++) {
+        double start = now_ns();
+        for (long i = 0; i < rounds; i++) {
+            fp8_to_float_n(src8, dst8.data(), dst8.size(), e5m2);
+        }
+        printf("%-16s %.3f ns per value\n", e5m2 ? "fp8 e5m2:" : "fp8 e4m3:",
+            (now_ns() - start) / ((double)rounds * dst8.size()));
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <vector>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * Cold start benchmark, times exec to exit of a command run many times
+ *
+ *     bench_startup COUNT COMMAND [ARGS...]
+ *
+ * The command's stdout goes to /dev/null so only startup, the work and
+ * teardown are measured.
+ */
+
+extern char **environ;
+
+static double now_us(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || atoi(argv[1]) < 1) {
+        fprintf(stderr, "bench_startup COUNT COMMAND [ARGS...]\n");
+        return 1;
+    }
+    int count = atoi(argv[1]);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    std::vector<double> times;
+    times.reserve(count);
+    for (int i = 0; i < count; i++) {
+        pid_t pid;
+        int status;
+        double start = now_us();
+        if (posix_spawn(&pid, argv[2], &actions, NULL, &argv[2], environ) != 0) {
+            perror(argv[2]);
+            return 1;
+        }
+        waitpid(pid, &status, 0);
+        times.push_back(now_us() - start);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "%s: failed with status %d\n", argv[2], status);
+            return 1;
+        }
+    }
+    posix_spawn_file_actions_destroy(&actions);
+
+    std::sort(times.begin(), times.end());
+    double sum = 0;
+    for (double t : times) {
+        sum += t;
+    }
+
+    printf("%-32s", "command:");
+    for (int i = 2; i < argc; i++) {
+        printf(" %s", argv[i]);
+    }
+    printf("\n");
+    printf("%-32s %.1f us\n", "mean exec to exit:", sum / count);
+    printf("%-32s %.1f us\n", "p50:", times[count / 2]);
+    printf("%-32s %.1f us\n", "p99:", times[(size_t)(count * 0.99)]);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "cpu.hpp"
+#include "wide.hpp"
+
+/**
+ * Bit vector benchmark, times the base and the CPU's variants of the
+ * kernels of 'hd --wide' on vectors of 4096 bits and checks they agree
+ *
+ *     bench_wide COUNT
+ */
+
+static double now_ns(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t xorshift(uint64_t *state) noexcept {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// each kernel count times over the same vectors, folded into a sum
+static double run(const WideKernels& k, int which, long count, uint64_t *sum) noexcept {
+    uint64_t a[WIDE_MAX_WORDS], b[WIDE_MAX_WORDS], out[WIDE_MAX_WORDS] = {};
+    uint64_t state = 0x9E3779B97F4A7C15;
+    for (size_t i = 0; i < WIDE_MAX_WORDS; i++) {
+        a[i] = xorshift(&state);
+        b[i] = xorshift(&state);
+    }
+    uint64_t acc = 0;
+    double start = now_ns();
+    for (long i = 0; i < count; i++) {
+        switch (which) {
+        case 0: k.bit_and(out, a, b, WIDE_MAX_WORDS); break;
+        case 1: k.bit_xor(out, a, b, WIDE_MAX_WORDS); break;
+        case 2: k.bit_clear(out, a, b, WIDE_MAX_WORDS); break;
+        case 3: k.inv(out, a, WIDE_MAX_WORDS); break;
+        case 4: out[0] = k.popcount(a, WIDE_MAX_WORDS); break;
+        }
+        acc += out[i % WIDE_MAX_WORDS];
+        a[0] += 1;
+    }
+    *sum = acc;
+    return (now_ns() - start) / count;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || atol(argv[1]) < 1) {
+        fprintf(stderr, "bench_wide COUNT\n");
+        return 1;
+    }
+    long count = atol(argv[1]);
+    static const char *names[] = {
+        "and", "xor", "andnot", "inv", "popcount",
+    };
+
+    WideKernels base = wide_kernels(0);
+    WideKernels best = wide_kernels(cpu_features());
+    cpu_print(stdout);
+    printf("%-16s %12s %12s\n", "ns per 4096", base.name, best.name);
+    int status = 0;
+    for (int i = 0; i < 5; i++) {
+        uint64_t base_sum, best_sum;
+        double base_ns = run(base, i, count, &base_sum);
+        double best_ns = run(best, i, count, &best_sum);
+        printf("%-16s %12.2f %12.2f\n", names[i], base_ns, best_ns);
+        if (base_sum != best_sum) {
+            fprintf(stderr, "%s: the variants disagree\n", names[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
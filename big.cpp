@@ -0,0 +1,715 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <utility>
+
+#include "big.hpp"
+
+typedef std::vector<uint64_t> Limbs;
+typedef unsigned __int128 Wide;
+
+#define KARATSUBA_LIMBS 32 // operands shorter than this are multiplied schoolbook
+#define NEWTON_LIMBS 40 // divisors longer than this are divided by their reciprocal
+#define DEC_SMALL_LIMBS 8 // values up to this are printed a limb of digits at a time
+#define DEC_BASE 10000000000000000000ull // the largest power of ten in a limb
+#define DEC_DIGITS 19
+#define BIG_BITS_MAX (1ull << 22) // results from a count larger than this are refused
+
+#ifndef M_LN2
+#define M_LN2 0.69314718055994530942
+#endif
+
+static thread_local std::deque<Big> pool;
+
+// powers of ten squared from DEC_BASE up, with their reciprocals once worth it
+struct DecPower {
+    Limbs power;
+    Limbs recip;
+};
+static thread_local std::vector<DecPower> dec_powers;
+
+static void trim(Limbs& a) noexcept {
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
+    }
+}
+
+static const Big *big_make(Limbs&& mag, bool neg) noexcept {
+    trim(mag);
+    pool.emplace_back();
+    Big *out = &pool.back();
+    out->mag = std::move(mag);
+    out->neg = neg && !out->mag.empty();
+    return out;
+}
+
+static size_t bit_length(const Limbs& a) noexcept {
+    return a.empty() ? 0 : 64 * a.size() - (size_t)__builtin_clzll(a.back());
+}
+
+static int cmp_mag(const Limbs& a, const Limbs& b) noexcept {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static Limbs add_mag(const Limbs& a, const Limbs& b) noexcept {
+    const Limbs& lo = a.size() < b.size() ? a : b;
+    const Limbs& hi = a.size() < b.size() ? b : a;
+    Limbs out(hi.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < hi.size(); i++) {
+        Wide sum = (Wide)hi[i] + (i < lo.size() ? lo[i] : 0) + carry;
+        out[i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
+    }
+    out[hi.size()] = carry;
+    trim(out);
+    return out;
+}
+
+// a - b, a no less than b
+static Limbs sub_mag(const Limbs& a, const Limbs& b) noexcept {
+    Limbs out(a.size());
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t y = i < b.size() ? b[i] : 0;
+        out[i] = a[i] - y - borrow;
+        borrow = borrow ? a[i] <= y : a[i] < y;
+    }
+    trim(out);
+    return out;
+}
+
+static Limbs add_one(const Limbs& a) noexcept {
+    return add_mag(a, Limbs(1, 1));
+}
+
+static Limbs sub_one(const Limbs& a) noexcept {
+    return sub_mag(a, Limbs(1, 1));
+}
+
+// out from limb at on += a, out has room for the carry
+static void add_at(Limbs& out, const Limbs& a, size_t at) noexcept {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < a.size(); i++) {
+        Wide sum = (Wide)out[at + i] + a[i] + carry;
+        out[at + i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
+    }
+    for (; carry; i++) {
+        carry = ++out[at + i] == 0;
+    }
+}
+
+static Limbs shl_mag(const Limbs& a, size_t bits) noexcept {
+    if (a.empty()) {
+        return Limbs();
+    }
+    size_t limbs = bits / 64;
+    unsigned shift = bits % 64;
+    Limbs out(a.size() + limbs + 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        out[i + limbs] |= a[i] << shift;
+        if (shift) {
+            out[i + limbs + 1] = a[i] >> (64 - shift);
+        }
+    }
+    trim(out);
+    return out;
+}
+
+static Limbs shr_mag(const Limbs& a, size_t bits) noexcept {
+    size_t limbs = bits / 64;
+    unsigned shift = bits % 64;
+    if (limbs >= a.size()) {
+        return Limbs();
+    }
+    Limbs out(a.size() - limbs);
+    for (size_t i = 0; i < out.size(); i++) {
+        out[i] = a[i + limbs] >> shift;
+        if (shift && i + limbs + 1 < a.size()) {
+            out[i] |= a[i + limbs + 1] << (64 - shift);
+        }
+    }
+    trim(out);
+    return out;
+}
+
+static Limbs pow2(size_t bits) noexcept {
+    Limbs out(bits / 64 + 1);
+    out.back() = (uint64_t)1 << (bits % 64);
+    return out;
+}
+
+static void mul_small(Limbs& a, uint64_t m) noexcept {
+    uint64_t carry = 0;
+    for (uint64_t& limb : a) {
+        Wide product = (Wide)limb * m + carry;
+        limb = (uint64_t)product;
+        carry = (uint64_t)(product >> 64);
+    }
+    if (carry) {
+        a.push_back(carry);
+    }
+    trim(a);
+}
+
+// a /= d, the remainder is returned
+static uint64_t divmod_small(Limbs& a, uint64_t d) noexcept {
+    Wide rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        Wide cur = (rem << 64) | a[i];
+        a[i] = (uint64_t)(cur / d);
+        rem = cur % d;
+    }
+    trim(a);
+    return (uint64_t)rem;
+}
+
+static Limbs mul_school(const uint64_t *a, size_t an, const uint64_t *b, size_t bn) noexcept {
+    Limbs out(an + bn);
+    for (size_t i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            Wide product = (Wide)a[i] * b[j] + out[i + j] + carry;
+            out[i + j] = (uint64_t)product;
+            carry = (uint64_t)(product >> 64);
+        }
+        out[i + bn] = carry;
+    }
+    trim(out);
+    return out;
+}
+
+static Limbs span(const uint64_t *a, size_t n) noexcept {
+    Limbs out(a, a + n);
+    trim(out);
+    return out;
+}
+
+/**
+ * Karatsuba, a = a1 B + a0 and b = b1 B + b0 make
+ * ab = a1 b1 B^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) B + a0 b0
+ * with three half size products. An operand shorter than half the other is
+ * multiplied by pieces of the other of its own length instead.
+ */
+static Limbs mul_span(const uint64_t *a, size_t an, const uint64_t *b, size_t bn) noexcept {
+    while (an > 0 && a[an - 1] == 0) {
+        an--;
+    }
+    while (bn > 0 && b[bn - 1] == 0) {
+        bn--;
+    }
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn == 0) {
+        return Limbs();
+    }
+    if (bn < KARATSUBA_LIMBS) {
+        return mul_school(a, an, b, bn);
+    }
+
+    Limbs out(an + bn + 1);
+    size_t half = (an + 1) / 2;
+    if (bn <= half) {
+        for (size_t at = 0; at < an; at += bn) {
+            size_t n = an - at < bn ? an - at : bn;
+            add_at(out, mul_span(a + at, n, b, bn), at);
+        }
+        trim(out);
+        return out;
+    }
+
+    Limbs low = mul_span(a, half, b, half);
+    Limbs high = mul_span(a + half, an - half, b + half, bn - half);
+    Limbs asum = add_mag(span(a, half), span(a + half, an - half));
+    Limbs bsum = add_mag(span(b, half), span(b + half, bn - half));
+    Limbs mid = mul_span(asum.data(), asum.size(), bsum.data(), bsum.size());
+    mid = sub_mag(sub_mag(mid, low), high);
+    add_at(out, low, 0);
+    add_at(out, mid, half);
+    add_at(out, high, 2 * half);
+    trim(out);
+    return out;
+}
+
+static Limbs mul_mag(const Limbs& a, const Limbs& b) noexcept {
+    return mul_span(a.data(), a.size(), b.data(), b.size());
+}
+
+// Knuth's algorithm D, a divisor of two limbs or more
+static void divmod_knuth(const Limbs& a, const Limbs& b, Limbs *q, Limbs *r) noexcept {
+    unsigned shift = (unsigned)__builtin_clzll(b.back());
+    Limbs v = shl_mag(b, shift);
+    Limbs u = shl_mag(a, shift);
+    u.resize(a.size() + 1);
+    size_t n = v.size();
+    size_t m = u.size() - n;
+    Limbs quot(m);
+    for (size_t j = m; j-- > 0;) {
+        Wide num = ((Wide)u[j + n] << 64) | u[j + n - 1];
+        Wide qhat = num / v[n - 1];
+        Wide rhat = num % v[n - 1];
+        while ((qhat >> 64) || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+            qhat--;
+            rhat += v[n - 1];
+            if (rhat >> 64) {
+                break;
+            }
+        }
+
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < n; i++) {
+            Wide product = qhat * v[i] + borrow;
+            uint64_t low = (uint64_t)product;
+            borrow = (uint64_t)(product >> 64) + (u[i + j] < low);
+            u[i + j] -= low;
+        }
+        bool under = u[j + n] < borrow;
+        u[j + n] -= borrow;
+        if (under) {
+            // qhat was one too many, add a divisor back
+            qhat--;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; i++) {
+                Wide sum = (Wide)u[i + j] + v[i] + carry;
+                u[i + j] = (uint64_t)sum;
+                carry = (uint64_t)(sum >> 64);
+            }
+            u[j + n] += carry;
+        }
+        quot[j] = (uint64_t)qhat;
+    }
+
+    trim(quot);
+    *q = std::move(quot);
+    u.resize(n);
+    trim(u);
+    *r = shr_mag(u, shift);
+}
+
+static void divmod_mag(const Limbs& a, const Limbs& b, Limbs *q, Limbs *r) noexcept;
+
+/**
+ * floor(2^2s / d) for d of s bits. The reciprocal of the top half of d is
+ * good to about half the bits, one Newton step x += x (2^2s - dx) / 2^2s
+ * doubles that and the remainder corrects the last units.
+ */
+static Limbs recip(const Limbs& d) noexcept {
+    size_t s = bit_length(d);
+    Limbs one = pow2(2 * s);
+    Limbs x;
+    if (d.size() <= NEWTON_LIMBS) {
+        Limbs rem;
+        divmod_mag(one, d, &x, &rem);
+        return x;
+    }
+
+    size_t h = s / 2 + 32;
+    x = shl_mag(recip(shr_mag(d, s - h)), s - h);
+    Limbs dx = mul_mag(d, x);
+    if (cmp_mag(dx, one) <= 0) {
+        x = add_mag(x, shr_mag(mul_mag(x, sub_mag(one, dx)), 2 * s));
+    } else {
+        Limbs fix = shr_mag(mul_mag(x, sub_mag(dx, one)), 2 * s);
+        x = cmp_mag(x, fix) > 0 ? sub_mag(x, fix) : Limbs();
+    }
+
+    dx = mul_mag(d, x);
+    while (cmp_mag(dx, one) > 0) {
+        x = sub_one(x);
+        dx = sub_mag(dx, d);
+    }
+    Limbs rem = sub_mag(one, dx);
+    while (cmp_mag(rem, d) >= 0) {
+        x = add_one(x);
+        rem = sub_mag(rem, d);
+    }
+    return x;
+}
+
+// a below 2^2s divided by d of s bits with its reciprocal, the estimate is short by at most two
+static void divmod_recip(const Limbs& a, const Limbs& d, const Limbs& inv, Limbs *q, Limbs *r) noexcept {
+    size_t s = bit_length(d);
+    Limbs quot = shr_mag(mul_mag(a, inv), 2 * s);
+    Limbs rem = sub_mag(a, mul_mag(quot, d));
+    while (cmp_mag(rem, d) >= 0) {
+        quot = add_one(quot);
+        rem = sub_mag(rem, d);
+    }
+    *q = std::move(quot);
+    *r = std::move(rem);
+}
+
+// count bits of a from bit from on
+static Limbs bits_at(const Limbs& a, size_t from, size_t count) noexcept {
+    size_t lo = from / 64;
+    size_t hi = lo + count / 64 + 2;
+    if (lo >= a.size()) {
+        return Limbs();
+    }
+    Limbs out = shr_mag(Limbs(a.begin() + lo, a.begin() + (hi < a.size() ? hi : a.size())), from % 64);
+    if (out.size() > count / 64) {
+        out.resize(count / 64 + 1);
+        out.back() &= ((uint64_t)1 << (count % 64)) - 1;
+    }
+    trim(out);
+    return out;
+}
+
+// long division in digits of s bits, each a division by the reciprocal
+static void divmod_newton(const Limbs& a, const Limbs& d, Limbs *q, Limbs *r) noexcept {
+    size_t s = bit_length(d);
+    Limbs inv = recip(d);
+    Limbs quot(a.size() + 1);
+    Limbs rem;
+    for (size_t i = (bit_length(a) + s - 1) / s; i-- > 0;) {
+        Limbs digit;
+        divmod_recip(add_mag(shl_mag(rem, s), bits_at(a, i * s, s)), d, inv, &digit, &rem);
+        add_at(quot, shl_mag(digit, i * s % 64), i * s / 64);
+    }
+    trim(quot);
+    *q = std::move(quot);
+    *r = std::move(rem);
+}
+
+static void divmod_mag(const Limbs& a, const Limbs& b, Limbs *q, Limbs *r) noexcept {
+    if (cmp_mag(a, b) < 0) {
+        q->clear();
+        *r = a;
+    } else if (b.size() == 1) {
+        *q = a;
+        uint64_t rem = divmod_small(*q, b[0]);
+        r->assign(rem ? 1 : 0, rem);
+    } else if (b.size() <= NEWTON_LIMBS || a.size() - b.size() <= NEWTON_LIMBS) {
+        divmod_knuth(a, b, q, r);
+    } else {
+        divmod_newton(a, b, q, r);
+    }
+}
+
+// product of lo up to hi, split in halves so the large products are balanced
+static Limbs product(uint64_t lo, uint64_t hi) noexcept {
+    if (hi - lo < 16) {
+        Limbs out(1, lo);
+        for (uint64_t i = lo; i < hi;) {
+            mul_small(out, ++i);
+        }
+        return out;
+    }
+    uint64_t mid = lo + (hi - lo) / 2;
+    return mul_mag(product(lo, mid), product(mid + 1, hi));
+}
+
+static bool too_large(double bits) noexcept {
+    return bits > (double)BIG_BITS_MAX;
+}
+
+const Big *big_from_uint(uint64_t value) noexcept {
+    return big_make(Limbs(1, value), false);
+}
+
+const Big *big_from_int(int64_t value) noexcept {
+    uint64_t mag = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    return big_make(Limbs(1, mag), value < 0);
+}
+
+const Big *big_from_uint128(Wide value) noexcept {
+    return big_make(Limbs{(uint64_t)value, (uint64_t)(value >> 64)}, false);
+}
+
+const Big *big_from_int128(__int128 value) noexcept {
+    Wide mag = value < 0 ? 0 - (Wide)value : (Wide)value;
+    return big_make(Limbs{(uint64_t)mag, (uint64_t)(mag >> 64)}, value < 0);
+}
+
+const Big *big_from_double(double value) noexcept {
+    if (!isfinite(value) || fabs(value) < 1) {
+        return big_make(Limbs(), false);
+    }
+    int exp;
+    double frac = frexp(fabs(value), &exp);
+    Limbs mag(1, (uint64_t)ldexp(frac, 64));
+    mag = exp >= 64 ? shl_mag(mag, (size_t)(exp - 64)) : shr_mag(mag, (size_t)(64 - exp));
+    return big_make(std::move(mag), value < 0);
+}
+
+const Big *big_from_decimal(const char *digits) noexcept {
+    bool neg = *digits == '-';
+    if (*digits == '-' || *digits == '+') {
+        digits++;
+    }
+    if (*digits == 0) {
+        return NULL;
+    }
+    Limbs mag;
+    while (*digits) {
+        uint64_t chunk = 0, scale = 1;
+        for (int i = 0; i < DEC_DIGITS && *digits; i++, digits++) {
+            if (*digits < '0' || *digits > '9') {
+                return NULL;
+            }
+            chunk = chunk * 10 + (uint64_t)(*digits - '0');
+            scale *= 10;
+        }
+        mul_small(mag, scale);
+        mag = add_mag(mag, Limbs(1, chunk));
+    }
+    return big_make(std::move(mag), neg);
+}
+
+static const Big *signed_add(const Big *a, const Limbs& b, bool bneg) noexcept {
+    if (a->neg == bneg) {
+        return big_make(add_mag(a->mag, b), bneg);
+    }
+    if (cmp_mag(a->mag, b) >= 0) {
+        return big_make(sub_mag(a->mag, b), a->neg);
+    }
+    return big_make(sub_mag(b, a->mag), bneg);
+}
+
+const Big *big_add(const Big *a, const Big *b) noexcept {
+    return signed_add(a, b->mag, b->neg);
+}
+
+const Big *big_sub(const Big *a, const Big *b) noexcept {
+    return signed_add(a, b->mag, !b->neg);
+}
+
+const Big *big_mul(const Big *a, const Big *b) noexcept {
+    return big_make(mul_mag(a->mag, b->mag), a->neg != b->neg);
+}
+
+const Big *big_div(const Big *a, const Big *b) noexcept {
+    if (b->mag.empty()) {
+        return NULL;
+    }
+    Limbs q, r;
+    divmod_mag(a->mag, b->mag, &q, &r);
+    return big_make(std::move(q), a->neg != b->neg);
+}
+
+const Big *big_mod(const Big *a, const Big *b) noexcept {
+    if (b->mag.empty()) {
+        return NULL;
+    }
+    Limbs q, r;
+    divmod_mag(a->mag, b->mag, &q, &r);
+    return big_make(std::move(r), a->neg);
+}
+
+const Big *big_neg(const Big *a) noexcept {
+    return big_make(Limbs(a->mag), !a->neg);
+}
+
+const Big *big_pow(const Big *base, uint64_t exp) noexcept {
+    size_t bits = bit_length(base->mag);
+    if (bits > 1 && too_large((double)(bits - 1) * (double)exp)) {
+        return NULL;
+    }
+    Limbs out(1, 1);
+    Limbs square = base->mag;
+    for (uint64_t e = exp; e; e >>= 1) {
+        if (e & 1) {
+            out = mul_mag(out, square);
+        }
+        if (e > 1) {
+            square = mul_mag(square, square);
+        }
+    }
+    return big_make(std::move(out), base->neg && (exp & 1));
+}
+
+const Big *big_factorial(uint64_t n) noexcept {
+    if (too_large(lgamma((double)n + 1) / M_LN2)) {
+        return NULL;
+    }
+    return big_make(n < 2 ? Limbs(1, 1) : product(2, n), false);
+}
+
+const Big *big_npr(uint64_t n, uint64_t r) noexcept {
+    if (r > n) {
+        return big_make(Limbs(), false);
+    }
+    if (too_large((lgamma((double)n + 1) - lgamma((double)(n - r) + 1)) / M_LN2)) {
+        return NULL;
+    }
+    return big_make(r == 0 ? Limbs(1, 1) : product(n - r + 1, n), false);
+}
+
+const Big *big_ncr(uint64_t n, uint64_t r) noexcept {
+    if (r > n) {
+        return big_make(Limbs(), false);
+    }
+    if (r > n - r) {
+        r = n - r;
+    }
+    double bits = lgamma((double)n + 1) - lgamma((double)r + 1) - lgamma((double)(n - r) + 1);
+    if (too_large(bits / M_LN2)) {
+        return NULL;
+    }
+    if (r == 0) {
+        return big_make(Limbs(1, 1), false);
+    }
+    Limbs q, rem;
+    divmod_mag(product(n - r + 1, n), product(1, r), &q, &rem);
+    return big_make(std::move(q), false);
+}
+
+int big_cmp(const Big *a, const Big *b) noexcept {
+    if (a->neg != b->neg) {
+        return a->neg ? -1 : 1;
+    }
+    int cmp = cmp_mag(a->mag, b->mag);
+    return a->neg ? -cmp : cmp;
+}
+
+uint64_t big_low(const Big *a) noexcept {
+    uint64_t low = a->mag.empty() ? 0 : a->mag[0];
+    return a->neg ? 0 - low : low;
+}
+
+Wide big_low128(const Big *a) noexcept {
+    Wide low = 0;
+    for (size_t i = 0; i < a->mag.size() && i < 2; i++) {
+        low |= (Wide)a->mag[i] << (64 * i);
+    }
+    return a->neg ? 0 - low : low;
+}
+
+double big_to_double(const Big *a) noexcept {
+    size_t bits = bit_length(a->mag);
+    size_t shift = bits > 64 ? bits - 64 : 0;
+    Limbs top = shr_mag(a->mag, shift);
+    double value = ldexp(top.empty() ? 0.0 : (double)top[0], shift > INT32_MAX ? INT32_MAX : (int)shift);
+    return a->neg ? -value : value;
+}
+
+// digits of shift bits each, straight from the limbs
+static void bits_string(const Limbs& a, unsigned shift, std::string& out) noexcept {
+    static const char digits[] = "0123456789ABCDEF";
+    size_t n = (bit_length(a) + shift - 1) / shift;
+    size_t at = out.size();
+    out.resize(at + n);
+    for (size_t i = 0; i < n; i++) {
+        size_t bit = i * shift;
+        size_t limb = bit / 64;
+        unsigned off = bit % 64;
+        uint64_t v = a[limb] >> off;
+        if (off + shift > 64 && limb + 1 < a.size()) {
+            v |= a[limb + 1] << (64 - off);
+        }
+        out[at + n - 1 - i] = digits[v & ((1u << shift) - 1)];
+    }
+}
+
+// a few limbs, one limb of digits per division
+static void dec_small(const Limbs& a, size_t width, std::string& out) noexcept {
+    char buf[DEC_SMALL_LIMBS * 20 + 24];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    Limbs rest = a;
+    while (!rest.empty()) {
+        uint64_t chunk = divmod_small(rest, DEC_BASE);
+        for (int i = 0; i < DEC_DIGITS && (chunk || !rest.empty()); i++) {
+            *--p = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    size_t len = (size_t)(end - p);
+    if (width > len) {
+        out.append(width - len, '0');
+    }
+    out.append(p, len);
+}
+
+/**
+ * Divide and conquer, a below power k squared is its quotient and remainder
+ * by power k, each printed by the level below. A padded part prints all of
+ * its DEC_DIGITS 2^(k+1) digits.
+ */
+static void dec_split(const Limbs& a, size_t k, bool pad, std::string& out) noexcept {
+    if (a.size() <= DEC_SMALL_LIMBS) {
+        dec_small(a, pad ? (size_t)DEC_DIGITS << (k + 1) : 0, out);
+        return;
+    }
+    const DecPower& power = dec_powers[k];
+    if (!pad && cmp_mag(a, power.power) < 0) {
+        dec_split(a, k - 1, false, out);
+        return;
+    }
+    Limbs q, r;
+    if (power.recip.empty()) {
+        divmod_mag(a, power.power, &q, &r);
+    } else {
+        divmod_recip(a, power.power, power.recip, &q, &r);
+    }
+    dec_split(q, k - 1, pad, out);
+    dec_split(r, k - 1, true, out);
+}
+
+static void dec_string(const Limbs& a, std::string& out) noexcept {
+    if (dec_powers.empty()) {
+        dec_powers.push_back(DecPower{ Limbs(1, DEC_BASE), Limbs() });
+    }
+    size_t k = 0;
+    for (;; k++) {
+        if (k + 1 == dec_powers.size()) {
+            const Limbs& top = dec_powers[k].power;
+            if (2 * top.size() - 1 > a.size()) {
+                break;
+            }
+            Limbs square = mul_mag(top, top);
+            Limbs inv = square.size() > NEWTON_LIMBS ? recip(square) : Limbs();
+            dec_powers.push_back(DecPower{ std::move(square), std::move(inv) });
+        }
+        if (cmp_mag(a, dec_powers[k + 1].power) < 0) {
+            break;
+        }
+    }
+    dec_split(a, k, false, out);
+}
+
+std::string big_to_string(const Big *a, unsigned base) noexcept {
+    std::string out;
+    if (a->neg) {
+        out += '-';
+    }
+    if (a->mag.empty()) {
+        out += '0';
+        return out;
+    }
+    switch (base) {
+    case 2:  bits_string(a->mag, 1, out); break;
+    case 8:  bits_string(a->mag, 3, out); break;
+    case 16: bits_string(a->mag, 4, out); break;
+    default: dec_string(a->mag, out); break;
+    }
+    return out;
+}
+
+size_t big_mark() noexcept {
+    return pool.size();
+}
+
+void big_release_to(size_t mark) noexcept {
+    while (pool.size() > mark) {
+        pool.pop_back();
+    }
+}
+
+void big_release() noexcept {
+    pool.clear();
+    dec_powers.clear();
+}
@@ -0,0 +1,57 @@
+#ifndef HD_BIG_H
+#define HD_BIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Arbitrary precision integers, what an integer result past the word size
+ * becomes with 'hd --bigint'
+ *
+ * A Big is a sign and a magnitude of 64 bit limbs, least significant first,
+ * without zero limbs on top, zero has no limbs. Results are owned by a pool
+ * of the calling thread and stay valid until big_release(), values never
+ * change once made so they can be shared like the other numbers.
+ */
+
+struct Big {
+    std::vector<uint64_t> mag;
+    bool neg;
+};
+
+const Big *big_from_int(int64_t value) noexcept;
+const Big *big_from_uint(uint64_t value) noexcept;
+const Big *big_from_double(double value) noexcept;
+const Big *big_from_int128(__int128 value) noexcept;
+const Big *big_from_uint128(unsigned __int128 value) noexcept;
+const Big *big_from_decimal(const char *digits) noexcept; // a sign ahead or none, NULL for a non digit
+
+const Big *big_add(const Big *a, const Big *b) noexcept;
+const Big *big_sub(const Big *a, const Big *b) noexcept;
+const Big *big_mul(const Big *a, const Big *b) noexcept;
+const Big *big_div(const Big *a, const Big *b) noexcept; // truncated, NULL for b zero
+const Big *big_mod(const Big *a, const Big *b) noexcept; // sign of a, NULL for b zero
+const Big *big_neg(const Big *a) noexcept;
+const Big *big_pow(const Big *base, uint64_t exp) noexcept;
+const Big *big_factorial(uint64_t n) noexcept;
+const Big *big_ncr(uint64_t n, uint64_t r) noexcept;
+const Big *big_npr(uint64_t n, uint64_t r) noexcept;
+
+int big_cmp(const Big *a, const Big *b) noexcept;
+uint64_t big_low(const Big *a) noexcept; // two's complement low 64 bits
+unsigned __int128 big_low128(const Big *a) noexcept; // and of 128
+double big_to_double(const Big *a) noexcept;
+
+// digits in base 2, 8, 10 or 16, a '-' ahead of a negative one
+std::string big_to_string(const Big *a, unsigned base) noexcept;
+
+// frees every Big the thread made
+void big_release() noexcept;
+
+// frees those the thread made since big_mark(), older ones stay valid
+size_t big_mark() noexcept;
+void big_release_to(size_t mark) noexcept;
+
+#endif // HD_BIG_H
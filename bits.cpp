@@ -0,0 +1,206 @@
+#include <stddef.h>
+
+#include "bits.hpp"
+#include "cpu.hpp"
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+static unsigned popcount_base(uint64_t value) noexcept {
+    return (unsigned)__builtin_popcountll(value);
+}
+
+static uint64_t mask_base(unsigned len) noexcept {
+    return len >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << len) - 1;
+}
+
+static uint64_t extract_base(uint64_t value, unsigned start, unsigned len) noexcept {
+    return (value >> start) & mask_base(len);
+}
+
+/**
+ * pdep and pext in six steps whatever the mask (Hacker's Delight 7-4, 7-5):
+ * step i moves the bits with an odd count of gaps to their right, counted
+ * in units of 2^i, down by 2^i. Depositing replays the moves backwards.
+ */
+
+// the bits moving at each step of compressing by mask
+static void gather_moves(uint64_t mask, uint64_t moves[6]) noexcept {
+    uint64_t gaps = ~mask << 1; // the zeros to the right of each bit, counted by prefix xor
+    for (unsigned i = 0; i < 6; i++) {
+        uint64_t odd = gaps ^ (gaps << 1);
+        odd ^= odd << 2;
+        odd ^= odd << 4;
+        odd ^= odd << 8;
+        odd ^= odd << 16;
+        odd ^= odd << 32;
+        moves[i] = odd & mask;
+        mask = (mask ^ moves[i]) | (moves[i] >> (1u << i));
+        gaps &= ~odd;
+    }
+}
+
+static uint64_t deposit_base(uint64_t value, uint64_t mask) noexcept {
+    uint64_t moves[6];
+    gather_moves(mask, moves);
+    for (unsigned i = 6; i-- > 0;) {
+        value = (value & ~moves[i]) | ((value << (1u << i)) & moves[i]);
+    }
+    return value & mask;
+}
+
+static uint64_t gather_base(uint64_t value, uint64_t mask) noexcept {
+    uint64_t moves[6];
+    gather_moves(mask, moves);
+    value &= mask;
+    for (unsigned i = 0; i < 6; i++) {
+        uint64_t t = value & moves[i];
+        value = (value ^ t) | (t >> (1u << i));
+    }
+    return value;
+}
+
+/**
+ * Morton codes by magic numbers, spreading doubles the gap between groups
+ * of bits at each step and compacting undoes the steps last to first. The
+ * first mask is that of the coordinate, the last that of the code.
+ */
+
+static const struct {
+    unsigned shift;
+    uint64_t mask;
+} morton2Magic[] = {
+    {0, 0x00000000FFFFFFFF},
+    {16, 0x0000FFFF0000FFFF},
+    {8, 0x00FF00FF00FF00FF},
+    {4, 0x0F0F0F0F0F0F0F0F},
+    {2, 0x3333333333333333},
+    {1, 0x5555555555555555},
+}, morton3Magic[] = {
+    {0, 0x00000000001FFFFF},
+    {32, 0x001F00000000FFFF},
+    {16, 0x001F0000FF0000FF},
+    {8, 0x100F00F00F00F00F},
+    {4, 0x10C30C30C30C30C3},
+    {2, 0x1249249249249249},
+};
+
+#define MORTON2_STEPS (sizeof(morton2Magic) / sizeof(*morton2Magic))
+#define MORTON3_STEPS (sizeof(morton3Magic) / sizeof(*morton3Magic))
+#define MORTON2_MASK 0x5555555555555555
+#define MORTON3_MASK 0x1249249249249249
+
+static uint64_t spread2_base(uint64_t value) noexcept {
+    value &= morton2Magic[0].mask;
+    for (size_t i = 1; i < MORTON2_STEPS; i++) {
+        value = (value | value << morton2Magic[i].shift) & morton2Magic[i].mask;
+    }
+    return value;
+}
+
+static uint64_t compact2_base(uint64_t code) noexcept {
+    code &= morton2Magic[MORTON2_STEPS - 1].mask;
+    for (size_t i = MORTON2_STEPS - 1; i > 0; i--) {
+        code = (code | code >> morton2Magic[i].shift) & morton2Magic[i - 1].mask;
+    }
+    return code;
+}
+
+static uint64_t spread3_base(uint64_t value) noexcept {
+    value &= morton3Magic[0].mask;
+    for (size_t i = 1; i < MORTON3_STEPS; i++) {
+        value = (value | value << morton3Magic[i].shift) & morton3Magic[i].mask;
+    }
+    return value;
+}
+
+static uint64_t compact3_base(uint64_t code) noexcept {
+    code &= morton3Magic[MORTON3_STEPS - 1].mask;
+    for (size_t i = MORTON3_STEPS - 1; i > 0; i--) {
+        code = (code | code >> morton3Magic[i].shift) & morton3Magic[i - 1].mask;
+    }
+    return code;
+}
+
+#ifdef CPU_X86
+__attribute__((target("popcnt")))
+static unsigned popcount_popcnt(uint64_t value) noexcept {
+    return (unsigned)__builtin_popcountll(value);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t mask_bmi2(unsigned len) noexcept {
+    return _bzhi_u64(~(uint64_t)0, len);
+}
+
+__attribute__((target("bmi")))
+static uint64_t extract_bmi(uint64_t value, unsigned start, unsigned len) noexcept {
+    return _bextr_u64(value, start, len);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t deposit_bmi2(uint64_t value, uint64_t mask) noexcept {
+    return _pdep_u64(value, mask);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t gather_bmi2(uint64_t value, uint64_t mask) noexcept {
+    return _pext_u64(value, mask);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t spread2_bmi2(uint64_t value) noexcept {
+    return _pdep_u64(value, MORTON2_MASK);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t compact2_bmi2(uint64_t code) noexcept {
+    return _pext_u64(code, MORTON2_MASK);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t spread3_bmi2(uint64_t value) noexcept {
+    return _pdep_u64(value, MORTON3_MASK);
+}
+
+__attribute__((target("bmi2")))
+static uint64_t compact3_bmi2(uint64_t code) noexcept {
+    return _pext_u64(code, MORTON3_MASK);
+}
+#endif
+
+BitKernels bits_kernels(unsigned features) noexcept {
+    BitKernels kernels = {
+        popcount_base, mask_base, extract_base,
+        deposit_base, gather_base,
+        spread2_base, compact2_base, spread3_base, compact3_base,
+        "base", "base",
+    };
+#ifdef CPU_X86
+    if (features & CPU_POPCNT) {
+        kernels.popcount = popcount_popcnt;
+        kernels.name = "popcnt";
+    }
+    if (features & CPU_BMI1) {
+        kernels.extract = extract_bmi;
+        kernels.name = "bmi1";
+    }
+    if (features & CPU_BMI2) {
+        kernels.mask = mask_bmi2;
+        kernels.name = "bmi2";
+    }
+    if (features & CPU_PDEP) {
+        kernels.deposit = deposit_bmi2;
+        kernels.gather = gather_bmi2;
+        kernels.spread2 = spread2_bmi2;
+        kernels.compact2 = compact2_bmi2;
+        kernels.spread3 = spread3_bmi2;
+        kernels.compact3 = compact3_bmi2;
+        kernels.deposit_name = "bmi2";
+    }
+#else
+    (void)features;
+#endif
+    return kernels;
+}
@@ -0,0 +1,29 @@
+#ifndef HD_BITS_H
+#define HD_BITS_H
+
+#include <stdint.h>
+
+/**
+ * Bit kernels of the operators, in variants for the extensions of
+ * cpu_features(). Every variant gives the same results, field lengths and
+ * starts past 63 are the callers' to clamp.
+ */
+
+struct BitKernels {
+    unsigned (* popcount)(uint64_t value);
+    uint64_t (* mask)(unsigned len); // the low len bits, len up to 64
+    uint64_t (* extract)(uint64_t value, unsigned start, unsigned len);
+    uint64_t (* deposit)(uint64_t value, uint64_t mask); // pdep
+    uint64_t (* gather)(uint64_t value, uint64_t mask); // pext
+    uint64_t (* spread2)(uint64_t value); // the low 32 bits to the even ones
+    uint64_t (* compact2)(uint64_t code); // the even bits to the low 32
+    uint64_t (* spread3)(uint64_t value); // the low 21 bits to every third
+    uint64_t (* compact3)(uint64_t code); // every third bit to the low 21
+    const char *name; // of the variant for popcount, mask and extract
+    const char *deposit_name; // of the one for the rest
+};
+
+// the fastest variants for features, a mask of CpuFeature
+BitKernels bits_kernels(unsigned features) noexcept;
+
+#endif // HD_BITS_H
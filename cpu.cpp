@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu.hpp"
+
+#define CPU_KERNELS 16
+
+// filled by the static initializers of the kernels, before main
+static struct {
+    const char *kernel;
+    const char *variant;
+} selected[CPU_KERNELS];
+static unsigned selected_count;
+
+static const struct {
+    const char *name;
+    unsigned feature;
+} featureTable[] = {
+    {"popcnt", CPU_POPCNT},
+    {"bmi1", CPU_BMI1},
+    {"bmi2", CPU_BMI2},
+    {"avx2", CPU_AVX2},
+    {"avx512bw", CPU_AVX512BW},
+    {"fast-pdep", CPU_PDEP},
+    {"f16c", CPU_F16C},
+    {"sse4.1", CPU_SSE41},
+    {NULL, 0},
+};
+
+static unsigned cpu_detect() noexcept {
+    const char *env = getenv("HD_CPU");
+    if (env && strcmp(env, "baseline") == 0) {
+        return 0;
+    }
+    unsigned features = 0;
+#ifdef CPU_X86
+    // initializers of other units can run before the one of libgcc
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt"))   features |= CPU_POPCNT;
+    if (__builtin_cpu_supports("bmi"))      features |= CPU_BMI1;
+    if (__builtin_cpu_supports("bmi2"))     features |= CPU_BMI2;
+    if (__builtin_cpu_supports("avx2"))     features |= CPU_AVX2;
+    if (__builtin_cpu_supports("avx512bw")) features |= CPU_AVX512BW;
+    if (__builtin_cpu_supports("f16c"))     features |= CPU_F16C;
+    if (__builtin_cpu_supports("sse4.1"))   features |= CPU_SSE41;
+    if ((features & CPU_BMI2) && !__builtin_cpu_is("znver1") && !__builtin_cpu_is("znver2")) {
+        features |= CPU_PDEP;
+    }
+#endif
+    return features;
+}
+
+unsigned cpu_features() noexcept {
+    static const unsigned features = cpu_detect();
+    return features;
+}
+
+void cpu_select(const char *kernel, const char *variant) noexcept {
+    if (selected_count < CPU_KERNELS) {
+        selected[selected_count].kernel = kernel;
+        selected[selected_count].variant = variant;
+        selected_count++;
+    }
+}
+
+void cpu_print(FILE *out) noexcept {
+    fprintf(out, "features:");
+    for (size_t i = 0; featureTable[i].name != NULL; i++) {
+        if (cpu_features() & featureTable[i].feature) {
+            fprintf(out, " %s", featureTable[i].name);
+        }
+    }
+    fprintf(out, "\n");
+    for (unsigned i = 0; i < selected_count; i++) {
+        fprintf(out, "%s: %s\n", selected[i].kernel, selected[i].variant);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef HD_CPU_H
+#define HD_CPU_H
+
+#include <stdio.h>
+
+/**
+ * Instruction set extensions of the CPU running hd
+ *
+ * hd is built for the baseline of its architecture. Kernels that gain from
+ * more come in variants compiled with target attributes, each picks one once
+ * at startup from cpu_features() and records it with cpu_select() for
+ * 'hd --cpu-features'. HD_CPU=baseline in the environment hides every
+ * extension, to run as an old machine would.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define CPU_X86
+#endif
+
+enum CpuFeature {
+    CPU_POPCNT = 1 << 0,
+    CPU_BMI1 = 1 << 1,
+    CPU_BMI2 = 1 << 2,
+    CPU_AVX2 = 1 << 3,
+    CPU_AVX512BW = 1 << 4,
+    CPU_PDEP = 1 << 5, // bmi2 pdep and pext, unless microcoded as on Zen 1 and 2
+    CPU_F16C = 1 << 6,
+    CPU_SSE41 = 1 << 7, // and ssse3, which every CPU with it has
+};
+
+unsigned cpu_features() noexcept;
+void cpu_select(const char *kernel, const char *variant) noexcept;
+void cpu_print(FILE *out) noexcept;
+
+#endif // HD_CPU_H
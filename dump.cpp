@@ -0,0 +1,158 @@
+#include <string.h>
+
+#include "cpu.hpp"
+#include "dump.hpp"
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+// byte i of a line is byte i ^ flip of the file, flip is group - 1 for
+// little endian groups as they are powers of 2
+static unsigned line_flip(unsigned group, bool little) noexcept {
+    return little ? group - 1 : 0;
+}
+
+static void hex_base(char *out, const unsigned char *bytes, unsigned group, bool little) noexcept {
+    unsigned flip = line_flip(group, little);
+    for (unsigned i = 0; i < DUMP_LINE; i++) {
+        unsigned byte = bytes[i ^ flip];
+        out[i * 2] = hex_digits[byte >> 4];
+        out[i * 2 + 1] = hex_digits[byte & 0x0F];
+    }
+}
+
+static char ascii_of(unsigned char byte) noexcept {
+    return byte >= 0x20 && byte < 0x7F ? (char)byte : '.';
+}
+
+static void ascii_base(char *out, const unsigned char *bytes) noexcept {
+    for (unsigned i = 0; i < DUMP_LINE; i++) {
+        out[i] = ascii_of(bytes[i]);
+    }
+}
+
+#ifdef CPU_X86
+// the digit of each nibble by pshufb on a table of the 16, the high and low
+// digits of each byte then interleaved
+__attribute__((target("ssse3")))
+static void hex_ssse3(char *out, const unsigned char *bytes, unsigned group, bool little) noexcept {
+    const __m128i table = _mm_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i x = _mm_loadu_si128((const __m128i *)bytes);
+    if (little) {
+        __m128i order = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        x = _mm_shuffle_epi8(x, _mm_xor_si128(order, _mm_set1_epi8((char)(group - 1))));
+    }
+    __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(x, 4), low));
+    __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(x, low));
+    _mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i *)&out[16], _mm_unpackhi_epi8(hi, lo));
+}
+
+// signed compares, the bytes from 0x80 are negative and below ' '
+__attribute__((target("ssse3")))
+static void ascii_ssse3(char *out, const unsigned char *bytes) noexcept {
+    __m128i x = _mm_loadu_si128((const __m128i *)bytes);
+    __m128i printable = _mm_and_si128(
+        _mm_cmpgt_epi8(x, _mm_set1_epi8(0x1F)), _mm_cmplt_epi8(x, _mm_set1_epi8(0x7F)));
+    __m128i r = _mm_or_si128(_mm_and_si128(printable, x), _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+    _mm_storeu_si128((__m128i *)out, r);
+}
+#endif
+
+DumpKernels dump_kernels(unsigned features) noexcept {
+    DumpKernels kernels = {hex_base, ascii_base, "base"};
+#ifdef CPU_X86
+    if (features & CPU_SSE41) {
+        kernels = {hex_ssse3, ascii_ssse3, "ssse3"};
+    }
+#else
+    (void)features;
+#endif
+    return kernels;
+}
+
+static char *put_offset(char *out, uint64_t offset, unsigned digits) noexcept {
+    while (digits < 16 && offset >> (digits * 4)) {
+        digits++;
+    }
+    for (unsigned i = digits; i-- > 0;) {
+        *out++ = hex_digits[(offset >> (i * 4)) & 0x0F];
+    }
+    *out++ = ':';
+    *out++ = ' ';
+    return out;
+}
+
+// inlined for each group size so the copies are of a known length
+__attribute__((always_inline))
+static inline char *put_groups(char *out, const char *hex, unsigned group) noexcept {
+    for (unsigned i = 0; i < DUMP_LINE; i += group) {
+        memcpy(out, &hex[i * 2], group * 2);
+        out += group * 2;
+        *out++ = ' ';
+    }
+    return out;
+}
+
+static char *put_line(char *out, const unsigned char *bytes, const DumpFormat& format,
+    const DumpKernels& kernels) noexcept {
+    char hex[DUMP_LINE * 2];
+    kernels.hex(hex, bytes, format.group, format.little);
+    switch (format.group) {
+    case 1: out = put_groups(out, hex, 1); break;
+    case 2: out = put_groups(out, hex, 2); break;
+    case 4: out = put_groups(out, hex, 4); break;
+    case 8: out = put_groups(out, hex, 8); break;
+    default: out = put_groups(out, hex, 16); break;
+    }
+    *out++ = ' ';
+    kernels.ascii(out, bytes);
+    out[DUMP_LINE] = '\n';
+    return out + DUMP_LINE + 1;
+}
+
+// the last line of less than 16 bytes, the digits of those missing as
+// spaces so the ASCII column lines up
+static char *put_tail(char *out, const unsigned char *bytes, size_t size, const DumpFormat& format) noexcept {
+    unsigned flip = line_flip(format.group, format.little);
+    for (unsigned i = 0; i < DUMP_LINE; i++) {
+        unsigned at = i ^ flip;
+        if (at < size) {
+            *out++ = hex_digits[bytes[at] >> 4];
+            *out++ = hex_digits[bytes[at] & 0x0F];
+        }
+        else {
+            *out++ = ' ';
+            *out++ = ' ';
+        }
+        if ((i + 1) % format.group == 0) {
+            *out++ = ' ';
+        }
+    }
+    *out++ = ' ';
+    for (size_t i = 0; i < size; i++) {
+        *out++ = ascii_of(bytes[i]);
+    }
+    *out++ = '\n';
+    return out;
+}
+
+size_t dump_lines(char *out, const unsigned char *data, size_t size, uint64_t offset,
+    const DumpFormat& format, const DumpKernels& kernels) noexcept {
+    char *start = out;
+    size_t at = 0;
+    for (; at + DUMP_LINE <= size; at += DUMP_LINE) {
+        out = put_offset(out, offset + at, format.digits);
+        out = put_line(out, &data[at], format, kernels);
+    }
+    if (at < size) {
+        out = put_offset(out, offset + at, format.digits);
+        out = put_tail(out, &data[at], size - at, format);
+    }
+    return (size_t)(out - start);
+}
@@ -0,0 +1,41 @@
+#ifndef HD_DUMP_H
+#define HD_DUMP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Hexdump of 'hd --dump', 16 bytes a line: the offset, the bytes in groups
+ * of a word and the bytes as ASCII, '.' for the unprintable ones
+ *
+ *     00000000: 7F454C46 02010100 00000000 00000000  .ELF............
+ *
+ * A group is the bytes in file order, or the word they make as a little
+ * endian number. The digits of a line come 16 bytes at once from a nibble
+ * table lookup (pshufb) in the SSSE3 variant, a byte at a time in the base.
+ */
+
+#define DUMP_LINE 16
+#define DUMP_LINE_MAX (16 + 2 + DUMP_LINE * 3 + 2 + DUMP_LINE + 1) // with a 64 bit offset and groups of a byte
+
+struct DumpFormat {
+    unsigned group; // bytes of a word, 1, 2, 4, 8 or 16
+    bool little; // groups as little endian words, the last byte first
+    unsigned digits; // of the offset at least, more as it grows
+};
+
+struct DumpKernels {
+    void (* hex)(char *out, const unsigned char *bytes, unsigned group, bool little); // the 32 digits of 16 bytes
+    void (* ascii)(char *out, const unsigned char *bytes); // the 16 characters of 16 bytes
+    const char *name;
+};
+
+// the fastest variants for features, a mask of CpuFeature
+DumpKernels dump_kernels(unsigned features) noexcept;
+
+// the lines of size bytes found at offset into out, DUMP_LINE_MAX chars a
+// line at most, returns the chars written
+size_t dump_lines(char *out, const unsigned char *data, size_t size, uint64_t offset,
+    const DumpFormat& format, const DumpKernels& kernels) noexcept;
+
+#endif // HD_DUMP_H
@@ -1,20 +1,43 @@
-#include <regex>
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <iostream>
 
+#include "cpu.hpp"
+#include "dump.hpp"
+#include "image.hpp"
 #include "rpn.hpp"
+#include "serve.hpp"
+#include "source.hpp"
+#include "store.hpp"
 #include "util.hpp"
 
+#ifdef HD_QUAD
+static RpnVtable rpn128 = RPN_VTABLE(128);
+#endif
 static RpnVtable rpn64 = RPN_VTABLE(64);
 static RpnVtable rpn32 = RPN_VTABLE(32);
 static RpnVtable rpn16 = RPN_VTABLE(16);
 static RpnVtable rpn8  = RPN_VTABLE(8);
+static RpnVtable rpnwide = RPN_VTABLE(Wide);
 static RpnVtable *rpn = &rpn64;
+static int workers = 0; // 0 for one per online CPU
+static const char *program_file = NULL;
+static const char *lib_file = NULL;
+static Store store;
+static const char *image_file = NULL; // to run
+static const char *image_out = NULL; // to compile to
+static const char *words_file = NULL; // to run the program over
+static int words_big = -1; // byte order of its words and those of --dump, -1 for native
 bool _verbose = true; // extern
 bool _longform = false; // extern
+bool _bigint = false; // extern
+bool _checked = false; // extern
+bool _bfloat16 = false; // extern
+bool _fp8e5m2 = false; // extern
+unsigned _bits = 0; // extern
+unsigned _wide = 0; // extern
 
 typedef void (* prog_func)(int argc, char **argv);
 
@@ -24,60 +47,113 @@ static void func_8(int argc, char **argv) noexcept;
 static void func_16(int argc, char **argv) noexcept;
 static void func_32(int argc, char **argv) noexcept;
 static void func_64(int argc, char **argv) noexcept;
+static void func_128(int argc, char **argv) noexcept;
+static void func_bits(int argc, char **argv) noexcept;
+static void func_wide(int argc, char **argv) noexcept;
 static void func_ord(int argc, char **argv) noexcept;
 static void func_chr(int argc, char **argv) noexcept;
 static void func_long(int argc, char **argv) noexcept;
+static void func_bigint(int argc, char **argv) noexcept;
+static void func_checked(int argc, char **argv) noexcept;
+static void func_bf16(int argc, char **argv) noexcept;
+static void func_fp8(int argc, char **argv) noexcept;
 static void func_verbose(int argc, char **argv) noexcept;
 static void func_endian(int argc, char **argv) noexcept;
+static void func_cpu_features(int argc, char **argv) noexcept;
 static void func_table(int argc, char **argv) noexcept;
 static void func_extable(int argc, char **argv) noexcept;
-static int arg_check(int argc, char **argv, const char *da, const char *ddarg) noexcept;
+static void func_file(int argc, char **argv) noexcept;
+static void func_lib(int argc, char **argv) noexcept;
+static void func_store(int argc, char **argv) noexcept;
+static void func_compile(int argc, char **argv) noexcept;
+static void func_words(int argc, char **argv) noexcept;
+static void func_order(int argc, char **argv) noexcept;
+static void func_dump(int argc, char **argv) noexcept;
+static void func_run(int argc, char **argv) noexcept;
+static void func_workers(int argc, char **argv) noexcept;
+static void func_serve(int argc, char **argv) noexcept;
+static int arg_find(const char *arg) noexcept;
 //static char *arg_get(int argc, char **argv, const char *da, const char *ddarg) noexcept;
 
 static void print_section(int number, const char *term) noexcept;
 //static int get_pivot(int argc, char **argv) noexcept;
 
-#define XENTRY(Da, Ddarg, ProgFunc, Whatdo) { \
+#define XENTRY(Da, Ddarg, Nargs, ProgFunc, Whatdo) { \
     (const char *)Da, \
     (const char *)Ddarg, \
+    (int)Nargs, \
     (prog_func)ProgFunc, \
     (const char *)Whatdo \
 }
 static struct {
     const char *da;
     const char *ddarg;
+    int nargs; // values following the option, not part of the program
     prog_func program;
     const char *whatdo;
 } argTable[] = {
-    XENTRY(NULL, "--8", func_8, "Set the operation word size to 8 bits, no floats"),
-    XENTRY(NULL, "--16", func_16, "Set the operation word size to 16 bits, no floats"),
-    XENTRY(NULL, "--32", func_32, "Set the operation word size to 32 bits"),
-    XENTRY(NULL, "--64", func_64, "Set the operation word size to 64 bits (default)"),
-    XENTRY("-c", "--chr", func_chr, "Get the character of the first number and exit"),
-    XENTRY("-o", "--ord", func_ord, "Get the code of the first character and exit"),
-    XENTRY("-l", "--long", func_long, "Print all parts of the number, including leading zeros"),
-    XENTRY("-t", "--table", func_table, "Get the ASCII table and exit"),
-    XENTRY("-e", "--extable", func_extable, "Get the ASCII table and its extended set and exit"),
-    XENTRY("-q", "--quiet", func_verbose, "Don't print errors to stderr"),
-    XENTRY(NULL, "--endianness", func_endian, "Display the endianness of the system to stdout"),
-    XENTRY("-h", "--help", func_help, "View this help and exit"),
-    XENTRY(NULL, NULL, NULL, NULL)
+    XENTRY(NULL, "--8", 0, func_8, "Set the operation word size to 8 bits, floats are FP8 E4M3"),
+    XENTRY(NULL, "--16", 0, func_16, "Set the operation word size to 16 bits, floats are IEEE half precision"),
+    XENTRY(NULL, "--32", 0, func_32, "Set the operation word size to 32 bits"),
+    XENTRY(NULL, "--64", 0, func_64, "Set the operation word size to 64 bits (default)"),
+    XENTRY(NULL, "--128", 0, func_128, "Set the operation word size to 128 bits, floats are IEEE quadruple precision"),
+    XENTRY(NULL, "--bits", 1, func_bits, "Set the operation word size to any bits from 1 to 64, results are masked to it and floats are doubles"),
+    XENTRY(NULL, "--wide", 1, func_wide, "Work on bit vectors of N bits up to 4096, with the bitwise operations, shifts, rotates and bit counts"),
+    XENTRY("-c", "--chr", 0, func_chr, "Get the character of the first number and exit"),
+    XENTRY("-o", "--ord", 0, func_ord, "Get the code of the first character and exit"),
+    XENTRY("-l", "--long", 0, func_long, "Print all parts of the number, including leading zeros"),
+    XENTRY(NULL, "--bigint", 0, func_bigint, "Integer results past the word size become bigints instead of wrapping"),
+    XENTRY(NULL, "--checked", 0, func_checked, "Integer add, sub, mul, div, pow, shl and abs results past the word size are errors instead of wrapping"),
+    XENTRY(NULL, "--bf16", 0, func_bf16, "Floats of the 16 bit word size are bfloat16 instead of half precision"),
+    XENTRY(NULL, "--fp8", 1, func_fp8, "Floats of the 8 bit word size, 'e4m3' (default) or 'e5m2'"),
+    XENTRY("-t", "--table", 0, func_table, "Get the ASCII table and exit"),
+    XENTRY("-e", "--extable", 0, func_extable, "Get the ASCII table and its extended set and exit"),
+    XENTRY("-q", "--quiet", 0, func_verbose, "Don't print errors to stderr"),
+    XENTRY(NULL, "--endianness", 0, func_endian, "Display the endianness of the system to stdout"),
+    XENTRY(NULL, "--cpu-features", 0, func_cpu_features, "Display the CPU extensions found and the kernels picked for them"),
+    XENTRY("-f", "--file", 1, func_file, "Run the program in a file before any given here, '#' comments a line"),
+    XENTRY(NULL, "--lib", 1, func_lib, "Load the macros of a file, 'def NAME ... enddef', before the program"),
+    XENTRY(NULL, "--store", 1, func_store, "Keep saved numbers in a file, shared with every hd using it and across runs"),
+    XENTRY(NULL, "--compile", 3, func_compile, "'--compile FILE -o IMAGE' compiles the program in a file, and any given here, for --run"),
+    XENTRY(NULL, "--words", 1, func_words, "Run the program once per word of a binary file, the word on the stack, a line per result"),
+    XENTRY(NULL, "--order", 1, func_order, "Byte order of the words of --words and --dump, 'big' or 'little' (default native)"),
+    XENTRY(NULL, "--dump", 1, func_dump, "Hexdump a file, 16 bytes a line in words of the word size and as ASCII, --long for 16 digit offsets"),
+    XENTRY(NULL, "--run", 1, func_run, "Run a compiled image before any program given here, at the word size it was compiled for"),
+    XENTRY("-j", "--workers", 1, func_workers, "Number of worker threads for --serve (default: online CPUs)"),
+    XENTRY(NULL, "--serve", 1, func_serve, "Evaluate programs sent to the Unix socket at the given path"),
+    XENTRY("-h", "--help", 0, func_help, "View this help and exit"),
+    XENTRY(NULL, NULL, 0, NULL, NULL)
 };
 #undef XENTRY
 
 int main(int argc, char **argv)
 {
     int pivot = 0;
+    int found[sizeof(argTable) / sizeof(argTable[0])] = {0};
     if (argc <= 1) {
         func_help(-1, NULL);
         exit(1);
     }
 
+    // one scan of argv for the first use of each option, skipping its values
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            int entry = arg_find(argv[i]);
+            if (entry >= 0) {
+                if (!found[entry]) {
+                    found[entry] = i;
+                }
+                i += argTable[entry].nargs;
+            }
+        }
+    }
+
+    // then run them in table order
     for (int i = 0; argTable[i].program != NULL; i++) {
-        int ndx = arg_check(argc, argv, argTable[i].da, argTable[i].ddarg);
+        int ndx = found[i];
         if (ndx) {
-            if (ndx > pivot) {
-                pivot = ndx;
+            if (ndx + argTable[i].nargs > pivot) {
+                pivot = ndx + argTable[i].nargs;
             }
             argTable[i].program(argc - ndx, &argv[ndx]);
         }
@@ -88,20 +164,191 @@ int main(int argc, char **argv)
     return 0;
 }
 
-static void func_rpn(int argc, char **argv) noexcept {
-    regex_init();
+// the engine and floats an image was compiled for, the current ones when it
+// can't tell
+static RpnVtable *image_engine(const Source *image) noexcept {
+    const ImageHeader *header = (const ImageHeader *)image->data;
+    if (image->size >= sizeof(ImageHeader)) {
+        switch (header->bits) {
+        case 8: _fp8e5m2 = header->floats == IMAGE_FLOATS_E5M2; return &rpn8;
+        case 16: _bfloat16 = header->floats == IMAGE_FLOATS_BF16; return &rpn16;
+        case 32: return &rpn32;
+        case 64: _bits = 0; return &rpn64;
+#ifdef HD_QUAD
+        case 128: return &rpn128;
+#endif
+        default:
+            if (header->bits >= 1 && header->bits < 64) {
+                _bits = header->bits;
+                return &rpn64;
+            }
+            break;
+        }
+    }
+    return rpn;
+}
+
+static void push_file(void *calc, const char *path) noexcept {
+    Source source;
+    const char *token;
+    size_t len;
+    if (!source_open(&source, path)) {
+        if (_verbose) fprintf(stderr, "file: %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    while (source_next(&source, &token, &len)) {
+        rpn->push_token(calc, token, len);
+    }
+    source_close(&source);
+}
+
+static void save_image(void *calc, const char *path) noexcept {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        if (_verbose) fprintf(stderr, "compile: %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    bool saved = rpn->save(calc, file);
+    if (fclose(file) != 0 || !saved) {
+        if (_verbose) fprintf(stderr, "compile: %s: %s\n", path, strerror(errno));
+        remove(path);
+        exit(1);
+    }
+}
+
+// words are read a step at a time, the output of each written out whole
+#define WORDS_STEP (1u << 16)
+
+// no locals live across the setjmp, the engine longjmps here on error
+static int map_step(void *calc, const char *data, size_t size, FILE *out) noexcept {
+    jmp_buf trap;
+    int status = setjmp(trap);
+    if (status == 0) {
+        _rpnout = out;
+        _rpntrap = &trap;
+        rpn->map(calc, data, size, words_big < 0 ? is_big_endian() : words_big == 1);
+    }
+    _rpntrap = NULL;
+    _rpnout = NULL;
+    return status;
+}
+
+// the program over every word of the file, the output of a step gathered in
+// memory so results cost no write each, the pages read given back
+static void map_file(void *calc, const char *path) noexcept {
+    Source source;
+    if (!source_open(&source, path)) {
+        if (_verbose) fprintf(stderr, "words: %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&buf, &len);
+    if (!out) {
+        if (_verbose) fprintf(stderr, "words: out of memory\n");
+        exit(ENOMEM);
+    }
+
+    // a multiple of every word size, so only the last step has a partial one
+    for (size_t at = 0; at < source.size; at += WORDS_STEP) {
+        size_t size = source.size - at < WORDS_STEP ? source.size - at : WORDS_STEP;
+        rewind(out);
+        int status = map_step(calc, &source.data[at], size, out);
+        fflush(out);
+        fwrite(buf, 1, len, stdout);
+        if (status) {
+            exit(status);
+        }
+        source_release(&source, at + size);
+    }
+    fclose(out);
+    free(buf);
+    source_close(&source);
+}
+
+// the lines of a step are written out at once from a buffer that holds them
+#define DUMP_STEP (1u << 16)
+
+static DumpKernels dump_select() noexcept {
+    DumpKernels kernels = dump_kernels(cpu_features());
+    cpu_select("hexdump", kernels.name);
+    return kernels;
+}
+
+static const DumpKernels dump_ops = dump_select();
+
+static void dump_file(const char *path, const DumpFormat& format) noexcept {
+    Source source;
+    if (!source_open(&source, path)) {
+        if (_verbose) fprintf(stderr, "dump: %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    char *buf = (char *)malloc(DUMP_STEP / DUMP_LINE * DUMP_LINE_MAX);
+    if (!buf) {
+        if (_verbose) fprintf(stderr, "dump: out of memory\n");
+        exit(ENOMEM);
+    }
+
+    // a multiple of 16, so only the last step has a partial line
+    for (size_t at = 0; at < source.size; at += DUMP_STEP) {
+        size_t size = source.size - at < DUMP_STEP ? source.size - at : DUMP_STEP;
+        size_t len = dump_lines(buf, (const unsigned char *)&source.data[at], size, at, format, dump_ops);
+        if (fwrite(buf, 1, len, stdout) != len) {
+            if (_verbose) fprintf(stderr, "dump: %s\n", strerror(errno));
+            exit(1);
+        }
+        source_release(&source, at + size);
+    }
+    free(buf);
+    source_close(&source);
+}
 
+static void func_rpn(int argc, char **argv) noexcept {
     int pivot = 1; // always 1 after '-r / --rpn' arg
+
+    // a lone literal like 'hd 10' needs no engine
+    if (!program_file && !lib_file && !image_file && !words_file && argc == pivot + 1 && rpn->convert(argv[pivot])) {
+        exit(0);
+    }
+
+    // mapped until exit, the words of the program point into it
+    Source image;
+    if (image_file) {
+        if (!source_open(&image, image_file)) {
+            if (_verbose) fprintf(stderr, "run: %s: %s\n", image_file, strerror(errno));
+            exit(1);
+        }
+        rpn = image_engine(&image);
+    }
+
     void *calc = rpn->create();
 
+    if (lib_file) {
+        push_file(calc, lib_file);
+    }
+    if (image_file && !rpn->load(calc, image.data, image.size)) {
+        exit(1);
+    }
+    if (program_file) {
+        push_file(calc, program_file);
+    }
     for (int i = pivot; i < argc; i++) {
         rpn->push(calc, (char *)argv[i]);
     }
 
+    if (image_out) {
+        save_image(calc, image_out);
+        exit(0);
+    }
+    if (words_file) {
+        map_file(calc, words_file);
+        rpn->destroy(calc);
+        exit(0);
+    }
+
     rpn->exec(calc);
     rpn->print(calc);
     rpn->destroy(calc);
-    regex_cleanup();
     exit(0);
 }
 
@@ -159,6 +406,47 @@ static void func_64(int argc, char **argv) noexcept {
     rpn = &rpn64;
 }
 
+static void func_128(int argc, char **argv) noexcept {
+    (void)argc;
+    (void)argv;
+#ifdef HD_QUAD
+    rpn = &rpn128;
+#else
+    if (_verbose) fprintf(stderr, "128: not supported by this build\n");
+    exit(1);
+#endif
+}
+
+static void func_bits(int argc, char **argv) noexcept {
+    char *end;
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "bits: Missing size\n");
+        exit(1);
+    }
+    unsigned long bits = strtoul(argv[1], &end, 10);
+    if (*end != 0 || bits < 1 || bits > 64) {
+        if (_verbose) fprintf(stderr, "bits: '%s' is not a size from 1 to 64\n", argv[1]);
+        exit(1);
+    }
+    _bits = bits == 64 ? 0 : (unsigned)bits;
+    rpn = &rpn64;
+}
+
+static void func_wide(int argc, char **argv) noexcept {
+    char *end;
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "wide: Missing size\n");
+        exit(1);
+    }
+    unsigned long bits = strtoul(argv[1], &end, 10);
+    if (*end != 0 || bits < 1 || bits > 4096) {
+        if (_verbose) fprintf(stderr, "wide: '%s' is not a size from 1 to 4096\n", argv[1]);
+        exit(1);
+    }
+    _wide = (unsigned)bits;
+    rpn = &rpnwide;
+}
+
 static void func_ord(int argc, char **argv) noexcept {
     if (argc < 2) {
         if (_verbose) fprintf(stderr, "ord: Missing value\n");
@@ -204,6 +492,41 @@ static void func_long(int argc, char **argv) noexcept {
     _longform = true;
 }
 
+static void func_bigint(int argc, char **argv) noexcept {
+    (void)argc;
+    (void)argv;
+    _bigint = true;
+}
+
+static void func_checked(int argc, char **argv) noexcept {
+    (void)argc;
+    (void)argv;
+    _checked = true;
+}
+
+static void func_bf16(int argc, char **argv) noexcept {
+    (void)argc;
+    (void)argv;
+    _bfloat16 = true;
+}
+
+static void func_fp8(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "fp8: Missing format\n");
+        exit(1);
+    }
+    if (strcmp(argv[1], "e4m3") == 0) {
+        _fp8e5m2 = false;
+    }
+    else if (strcmp(argv[1], "e5m2") == 0) {
+        _fp8e5m2 = true;
+    }
+    else {
+        if (_verbose) fprintf(stderr, "fp8: '%s' is not e4m3 or e5m2\n", argv[1]);
+        exit(1);
+    }
+}
+
 static void func_endian(int argc, char **argv) noexcept {
     (void)argc;
     (void)argv;
@@ -217,6 +540,123 @@ static void func_endian(int argc, char **argv) noexcept {
     exit(0);
 }
 
+static void func_cpu_features(int argc, char **argv) noexcept {
+    (void)argc;
+    (void)argv;
+    cpu_print(stdout);
+    fflush(stdout);
+    exit(0);
+}
+
+static void func_file(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "file: Missing path\n");
+        exit(1);
+    }
+    program_file = argv[1];
+}
+
+static void func_lib(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "lib: Missing path\n");
+        exit(1);
+    }
+    lib_file = argv[1];
+}
+
+static void func_store(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "store: Missing path\n");
+        exit(1);
+    }
+    if (!store_open(&store, argv[1])) {
+        if (_verbose) fprintf(stderr, "store: %s: %s\n", argv[1], strerror(errno));
+        exit(1);
+    }
+    _rpnstore = &store;
+}
+
+static void func_compile(int argc, char **argv) noexcept {
+    if (argc < 4 || strcmp(argv[2], "-o") != 0) {
+        if (_verbose) fprintf(stderr, "compile: Expected '--compile FILE -o IMAGE'\n");
+        exit(1);
+    }
+    program_file = argv[1];
+    image_out = argv[3];
+}
+
+static void func_words(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "words: Missing path\n");
+        exit(1);
+    }
+    words_file = argv[1];
+}
+
+static void func_order(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "order: Missing byte order\n");
+        exit(1);
+    }
+    if (strcmp(argv[1], "big") == 0) {
+        words_big = 1;
+    }
+    else if (strcmp(argv[1], "little") == 0) {
+        words_big = 0;
+    }
+    else {
+        if (_verbose) fprintf(stderr, "order: '%s' is not big or little\n", argv[1]);
+        exit(1);
+    }
+}
+
+static void func_dump(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "dump: Missing path\n");
+        exit(1);
+    }
+    DumpFormat format;
+    if (rpn == &rpn8) format.group = 1;
+    else if (rpn == &rpn16) format.group = 2;
+    else if (rpn == &rpn32) format.group = 4;
+    else if (rpn == &rpn64) format.group = 8;
+#ifdef HD_QUAD
+    else if (rpn == &rpn128) format.group = 16;
+#endif
+    else {
+        if (_verbose) fprintf(stderr, "dump: not supported with --wide\n");
+        exit(1);
+    }
+    format.little = words_big < 0 ? !is_big_endian() : words_big == 0;
+    format.digits = _longform ? 16 : 8;
+    dump_file(argv[1], format);
+    exit(0);
+}
+
+static void func_run(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "run: Missing path\n");
+        exit(1);
+    }
+    image_file = argv[1];
+}
+
+static void func_workers(int argc, char **argv) noexcept {
+    if (argc < 2 || sscanf(argv[1], "%d", &workers) != 1 || workers < 1) {
+        if (_verbose) fprintf(stderr, "workers: Expected a positive count\n");
+        exit(1);
+    }
+}
+
+static void func_serve(int argc, char **argv) noexcept {
+    if (argc < 2) {
+        if (_verbose) fprintf(stderr, "serve: Missing socket path\n");
+        exit(1);
+    }
+
+    exit(serve_main(argv[1], rpn, workers));
+}
+
 static void print_table(void) noexcept {
     for (int i = 0; i < (128 / 4); i++) {
         print_section(i, "\t");
@@ -252,14 +692,14 @@ static void func_extable(int argc, char **argv) noexcept {
     exit(0);
 }
 
-static int arg_check(int argc, char **argv, const char *da, const char *ddarg) noexcept {
-    int i;
-    for (i = 0; i < argc; i++) {
-        if ((da && strcmp(argv[i], da) == 0) || (ddarg && strcmp(argv[i], ddarg) == 0)) {
+static int arg_find(const char *arg) noexcept {
+    for (int i = 0; argTable[i].program != NULL; i++) {
+        if ((argTable[i].da && strcmp(arg, argTable[i].da) == 0) ||
+            (argTable[i].ddarg && strcmp(arg, argTable[i].ddarg) == 0)) {
             return i;
         }
     }
-    return 0;
+    return -1;
 }
 
 #if 0
@@ -0,0 +1,225 @@
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bashbuiltin.h"
+#include "rpn.hpp"
+
+/**
+ * hd as a bash loadable builtin
+ *
+ *     enable -f ./hd.so hd
+ *     hd -v x 0b101 5 mul hex as
+ *
+ * Runs in the shell process, so engine errors are trapped and become the
+ * builtin's return status rather than exiting.
+ */
+
+#define EXPORT __attribute__((visibility("default")))
+
+#ifdef HD_QUAD
+static RpnVtable rpn128 = RPN_VTABLE(128);
+#endif
+static RpnVtable rpn64 = RPN_VTABLE(64);
+static RpnVtable rpn32 = RPN_VTABLE(32);
+static RpnVtable rpn16 = RPN_VTABLE(16);
+static RpnVtable rpn8  = RPN_VTABLE(8);
+static RpnVtable rpnwide = RPN_VTABLE(Wide);
+bool _verbose = true; // extern
+bool _longform = false; // extern
+bool _bigint = false; // extern
+bool _checked = false; // extern
+bool _bfloat16 = false; // extern
+bool _fp8e5m2 = false; // extern
+unsigned _bits = 0; // extern
+unsigned _wide = 0; // extern
+
+static void run(RpnVtable *rpn, void *calc, char **tokens, size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        rpn->push(calc, tokens[i]);
+    }
+    rpn->exec(calc);
+    rpn->print(calc);
+}
+
+// the engine longjmps here on error, calc is volatile to survive that
+static int evaluate(RpnVtable *rpn, char **tokens, size_t count, FILE *out) noexcept {
+    jmp_buf trap;
+    void *volatile calc = NULL;
+    int status = setjmp(trap);
+    if (status == 0) {
+        _rpnout = out;
+        _rpntrap = &trap;
+        calc = rpn->create();
+        run(rpn, calc, tokens, count);
+    }
+    _rpntrap = NULL;
+    _rpnout = NULL;
+    if (calc) {
+        rpn->destroy(calc);
+    }
+    return status;
+}
+
+// like $(hd ...) without the fork, output minus trailing newlines
+static int evaluate_into(const char *name, RpnVtable *rpn, char **tokens, size_t count) noexcept {
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&buf, &len);
+    if (!out) {
+        builtin_error("out of memory");
+        return EXECUTION_FAILURE;
+    }
+
+    int status = evaluate(rpn, tokens, count, out);
+    fclose(out);
+    if (status == 0) {
+        while (len > 0 && buf[len - 1] == '\n') {
+            buf[--len] = 0;
+        }
+        bind_variable(name, buf, 0);
+    }
+    free(buf);
+    return status;
+}
+
+extern "C" EXPORT int hd_builtin(WORD_LIST *list) {
+    RpnVtable *rpn = &rpn64;
+    const char *name = NULL;
+
+    _verbose = true;
+    _longform = false;
+    _bigint = false;
+    _checked = false;
+    _bfloat16 = false;
+    _fp8e5m2 = false;
+    _bits = 0;
+    _wide = 0;
+    for (; list; list = list->next) {
+        const char *arg = list->word->word;
+        if (strcmp(arg, "-v") == 0) {
+            if (!list->next) {
+                builtin_usage();
+                return EX_USAGE;
+            }
+            list = list->next;
+            name = list->word->word;
+            if (!legal_identifier(name)) {
+                builtin_error("`%s': not a valid identifier", name);
+                return EXECUTION_FAILURE;
+            }
+        }
+        else if (strcmp(arg, "--8") == 0)  rpn = &rpn8;
+        else if (strcmp(arg, "--16") == 0) rpn = &rpn16;
+        else if (strcmp(arg, "--32") == 0) rpn = &rpn32;
+        else if (strcmp(arg, "--64") == 0) rpn = &rpn64;
+#ifdef HD_QUAD
+        else if (strcmp(arg, "--128") == 0) rpn = &rpn128;
+#endif
+        else if (strcmp(arg, "-l") == 0 || strcmp(arg, "--long") == 0) _longform = true;
+        else if (strcmp(arg, "-q") == 0 || strcmp(arg, "--quiet") == 0) _verbose = false;
+        else if (strcmp(arg, "--bigint") == 0) _bigint = true;
+        else if (strcmp(arg, "--checked") == 0) _checked = true;
+        else if (strcmp(arg, "--bf16") == 0) _bfloat16 = true;
+        else if (strcmp(arg, "--bits") == 0) {
+            const char *size = list->next ? list->next->word->word : "";
+            char *end;
+            unsigned long bits = strtoul(size, &end, 10);
+            if (*end != 0 || bits < 1 || bits > 64) {
+                builtin_usage();
+                return EX_USAGE;
+            }
+            list = list->next;
+            _bits = bits == 64 ? 0 : (unsigned)bits;
+            rpn = &rpn64;
+        }
+        else if (strcmp(arg, "--wide") == 0) {
+            const char *size = list->next ? list->next->word->word : "";
+            char *end;
+            unsigned long bits = strtoul(size, &end, 10);
+            if (*end != 0 || bits < 1 || bits > 4096) {
+                builtin_usage();
+                return EX_USAGE;
+            }
+            list = list->next;
+            _wide = (unsigned)bits;
+            rpn = &rpnwide;
+        }
+        else if (strcmp(arg, "--fp8") == 0) {
+            const char *format = list->next ? list->next->word->word : "";
+            if (strcmp(format, "e4m3") != 0 && strcmp(format, "e5m2") != 0) {
+                builtin_usage();
+                return EX_USAGE;
+            }
+            list = list->next;
+            _fp8e5m2 = strcmp(format, "e5m2") == 0;
+        }
+        else if (strcmp(arg, "--") == 0) {
+            list = list->next;
+            break;
+        }
+        else {
+            break;
+        }
+    }
+
+    std::vector<char *> tokens;
+    for (; list; list = list->next) {
+        tokens.push_back(list->word->word);
+    }
+    if (tokens.empty()) {
+        builtin_usage();
+        return EX_USAGE;
+    }
+
+    if (name) {
+        return evaluate_into(name, rpn, tokens.data(), tokens.size());
+    }
+    int status = evaluate(rpn, tokens.data(), tokens.size(), NULL);
+    fflush(stdout);
+    return status;
+}
+
+static const char *const hd_doc[] = {
+    "Hexadecimal -- representation utility.",
+    "",
+    "Evaluates PROGRAM exactly like the hd command, without starting a",
+    "process. Run 'hd --help' outside the builtin for the operations.",
+    "",
+    "Options:",
+    "  -v var\tassign the output to the shell variable VAR, trailing",
+    "        \tnewlines removed, instead of printing it",
+    "  -l    \tprint all parts of the number, including leading zeros",
+    "  -q    \tdon't print errors",
+    "  --bigint",
+    "        \tinteger results past the word size become bigints",
+    "  --checked",
+    "        \tinteger results past the word size are errors",
+    "  --8, --16, --32, --64, --128",
+    "        \tset the operation word size (default 64)",
+    "  --bits N",
+    "        \tset the word size to N bits from 1 to 64, results masked",
+    "  --wide N",
+    "        \tbit vectors of N bits up to 4096, bitwise operations only",
+    "  --bf16\tfloats of 16 bits are bfloat16 instead of half precision",
+    "  --fp8 e4m3|e5m2",
+    "        \tthe float format of 8 bits (default e4m3)",
+    "",
+    "Exit Status:",
+    "Returns the exit status the hd command would have.",
+    NULL
+};
+
+extern "C" {
+
+EXPORT struct builtin hd_struct = {
+    "hd",
+    hd_builtin,
+    BUILTIN_ENABLED,
+    hd_doc,
+    "hd [-v var] [-lq] [--bigint] [--checked] [--bf16] [--fp8 e4m3|e5m2] [--8|--16|--32|--64|--128|--bits N|--wide N] PROGRAM...",
+    NULL,
+};
+
+}
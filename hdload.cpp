@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "serve.hpp"
+
+/**
+ * Load generator for 'hd --serve'
+ *
+ * Every connection sends the program back to back, waiting for each answer,
+ * and the latency of each round trip is recorded.
+ */
+
+struct Worker {
+    std::vector<double> latency; // microseconds
+    std::string first; // output of the first answer
+    long failed;
+};
+
+static const char *socket_path;
+static std::string program;
+static long requests = 10000;
+static int connections = 1;
+
+static double now_us(void) noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static bool write_all(int fd, const char *buf, size_t len) noexcept {
+    while (len) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool read_all(int fd, char *buf, size_t len) noexcept {
+    while (len) {
+        ssize_t n = read(fd, buf, len);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static int connect_to(const char *path) noexcept {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "hdload: %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+static void worker_main(Worker *self, long count) noexcept {
+    int fd = connect_to(socket_path);
+
+    uint32_t len = htonl((uint32_t)program.size());
+    std::vector<char> frame(sizeof(len) + program.size());
+    memcpy(&frame[0], &len, sizeof(len));
+    memcpy(&frame[sizeof(len)], program.data(), program.size());
+
+    std::vector<char> body;
+    self->latency.reserve(count);
+    for (long i = 0; i < count; i++) {
+        uint32_t header[2];
+        double start = now_us();
+        if (!write_all(fd, frame.data(), frame.size()) ||
+            !read_all(fd, (char *)header, sizeof(header))) {
+            fprintf(stderr, "hdload: connection lost\n");
+            exit(1);
+        }
+        body.resize(ntohl(header[0]));
+        if (!body.empty() && !read_all(fd, body.data(), body.size())) {
+            fprintf(stderr, "hdload: connection lost\n");
+            exit(1);
+        }
+        self->latency.push_back(now_us() - start);
+
+        if (ntohl(header[1]) != 0) {
+            self->failed++;
+        }
+        if (i == 0) {
+            self->first.assign(body.begin(), body.end());
+        }
+    }
+    close(fd);
+}
+
+static double percentile(const std::vector<double>& sorted, double p) noexcept {
+    size_t ndx = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[ndx];
+}
+
+static void usage(void) noexcept {
+    fprintf(stderr,
+        "hdload -- load generator for 'hd --serve'\n\n"
+        "\thdload SOCKET [-c CONNECTIONS] [-n REQUESTS] PROGRAM...\n\n"
+        "\t-c; Concurrent connections (default: 1)\n"
+        "\t-n; Total requests across all connections (default: 10000)\n"
+    );
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        usage();
+    }
+    socket_path = argv[1];
+
+    int i;
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            connections = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            requests = atol(argv[++i]);
+        }
+        else {
+            break;
+        }
+    }
+    if (i == argc || connections < 1 || requests < connections) {
+        usage();
+    }
+    for (; i < argc; i++) {
+        program += argv[i];
+        program += i + 1 < argc ? " " : "";
+    }
+
+    std::vector<Worker> workers(connections);
+    std::vector<std::thread> threads;
+    double start = now_us();
+    for (int c = 0; c < connections; c++) {
+        long count = requests / connections + (c < requests % connections ? 1 : 0);
+        threads.emplace_back(worker_main, &workers[c], count);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double elapsed = now_us() - start;
+
+    std::vector<double> all;
+    long failed = 0;
+    for (auto& w : workers) {
+        all.insert(all.end(), w.latency.begin(), w.latency.end());
+        failed += w.failed;
+    }
+    std::sort(all.begin(), all.end());
+
+    printf("program:     %s\n", program.c_str());
+    printf("answer:      %s", workers[0].first.c_str());
+    printf("connections: %d\n", connections);
+    printf("requests:    %ld (%ld failed)\n", (long)all.size(), failed);
+    printf("p50:         %.1f us\n", percentile(all, 0.50));
+    printf("p99:         %.1f us\n", percentile(all, 0.99));
+    printf("throughput:  %.0f req/s\n", (double)all.size() / (elapsed / 1e6));
+    return failed ? 1 : 0;
+}
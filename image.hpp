@@ -0,0 +1,59 @@
+#ifndef HD_IMAGE_H
+#define HD_IMAGE_H
+
+#include <stdint.h>
+
+/**
+ * Compiled program image, written by 'hd --compile' and run by 'hd --run'
+ *
+ *     ImageHeader
+ *     ImageInsn[count]
+ *     char strings[strings] // NUL terminated texts of words
+ *
+ * An image is only valid for the engine width, float format and operation
+ * table that compiled it, all are recorded and checked on load. Integers are in the
+ * byte order of the writer, order tells a foreign one apart.
+ */
+
+#define IMAGE_MAGIC "HDC\x1a"
+#define IMAGE_VERSION 2
+#define IMAGE_ORDER 0x01020304u
+
+// float formats a word size has besides its default, IEEE or FP8 E4M3
+enum ImageFloats {
+    IMAGE_FLOATS_DEFAULT,
+    IMAGE_FLOATS_BF16, // --16 --bf16
+    IMAGE_FLOATS_E5M2, // --8 --fp8 e5m2
+};
+
+struct ImageHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t order;
+    uint32_t bits; // word size of the engine
+    uint32_t ops; // fingerprint of the operation names, in table order
+    uint32_t count; // instructions
+    uint32_t floats; // ImageFloats of the engine
+    uint32_t reserved;
+    uint64_t strings; // bytes of the string table
+};
+
+enum ImageKind {
+    IMAGE_OP, // arg is the index of the operation
+    IMAGE_VALUE, // a number in imm, or a word at string offset arg
+    IMAGE_WIDE, // a number past imm, the hex digits of its bits at string offset arg
+};
+
+struct ImageInsn {
+    uint8_t kind;
+    uint8_t type; // Value type and format of IMAGE_VALUE
+    uint8_t fmt;
+    uint8_t reserved;
+    uint32_t arg;
+    uint64_t imm;
+};
+
+static_assert(sizeof(ImageHeader) == 40, "image header layout");
+static_assert(sizeof(ImageInsn) == 16, "image instruction layout");
+
+#endif // HD_IMAGE_H
@@ -0,0 +1,176 @@
+#include "cpu.hpp"
+#include "lanes.hpp"
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+/**
+ * SWAR (Hacker's Delight 2-18): the top bit of each lane is worked apart so
+ * no carry or borrow crosses into the next lane, the carries out of the
+ * lanes are then rebuilt from the operands' top bits.
+ */
+
+// the top bit of each lane
+static uint64_t lane_top(unsigned lane) noexcept {
+    switch (lane) {
+    case 8: return 0x8080808080808080;
+    case 16: return 0x8000800080008000;
+    default: return 0x8000000080000000;
+    }
+}
+
+// each lane with its top bit set to all ones, the rest to zeros
+static uint64_t lane_spread(uint64_t top, unsigned lane) noexcept {
+    return (top >> (lane - 1)) * (((uint64_t)1 << lane) - 1);
+}
+
+static uint64_t add_swar(uint64_t a, uint64_t b, uint64_t h) noexcept {
+    return ((a & ~h) + (b & ~h)) ^ ((a ^ b) & h);
+}
+
+static uint64_t sub_swar(uint64_t a, uint64_t b, uint64_t h) noexcept {
+    return ((a | h) - (b & ~h)) ^ ((a ^ ~b) & h);
+}
+
+// the top bits of the lanes where a > b
+static uint64_t greater_swar(uint64_t a, uint64_t b, uint64_t h, bool is_signed) noexcept {
+    if (is_signed) {
+        a ^= h;
+        b ^= h;
+    }
+    uint64_t d = sub_swar(b, a, h);
+    return ((~b & a) | (~(b ^ a) & d)) & h; // the borrows of b - a
+}
+
+static uint64_t op_base(LaneOp op, uint64_t a, uint64_t b, unsigned lane, bool is_signed) noexcept {
+    uint64_t h = lane_top(lane);
+    uint64_t r, m;
+    switch (op) {
+    case LANE_ADD:
+        return add_swar(a, b, h);
+    case LANE_SUB:
+        return sub_swar(a, b, h);
+    case LANE_SAT_ADD:
+        r = add_swar(a, b, h);
+        if (is_signed) {
+            // overflowed lanes to the limit of the sign of a, 0x7F + 1 for negatives
+            m = lane_spread(~(a ^ b) & (a ^ r) & h, lane);
+            return (r & ~m) | ((~h + ((a & h) >> (lane - 1))) & m);
+        }
+        return r | lane_spread(((a & b) | ((a | b) & ~r)) & h, lane);
+    case LANE_SAT_SUB:
+        r = sub_swar(a, b, h);
+        if (is_signed) {
+            m = lane_spread((a ^ b) & (a ^ r) & h, lane);
+            return (r & ~m) | ((~h + ((a & h) >> (lane - 1))) & m);
+        }
+        return r & ~lane_spread(((~a & b) | (~(a ^ b) & r)) & h, lane);
+    case LANE_MIN:
+        m = lane_spread(greater_swar(a, b, h, is_signed), lane);
+        return (b & m) | (a & ~m);
+    case LANE_MAX:
+        m = lane_spread(greater_swar(a, b, h, is_signed), lane);
+        return (a & m) | (b & ~m);
+    case LANE_CMPEQ:
+        r = a ^ b;
+        return lane_spread(~(((r & ~h) + ~h) | r) & h, lane); // the lanes without a set bit
+    case LANE_CMPGT:
+        return lane_spread(greater_swar(a, b, h, is_signed), lane);
+    }
+    return 0;
+}
+
+static uint64_t shuffle_base(uint64_t a, uint64_t sel) noexcept {
+    uint64_t r = 0;
+    for (unsigned i = 0; i < 64; i += 8) {
+        unsigned s = (unsigned)(sel >> i) & 0xFF;
+        if (!(s & 0x80)) {
+            r |= ((a >> (s & 7) * 8) & 0xFF) << i;
+        }
+    }
+    return r;
+}
+
+#ifdef CPU_X86
+#define LANE_PICK(lane, e8, e16, e32) ((lane) == 8 ? (e8) : (lane) == 16 ? (e16) : (e32))
+
+// the packed instructions on the low half of a register, 32 bit lanes
+// saturate by SWAR as SSE has nothing for them
+__attribute__((target("sse4.1")))
+static uint64_t op_sse(LaneOp op, uint64_t a, uint64_t b, unsigned lane, bool is_signed) noexcept {
+    __m128i x = _mm_set_epi64x(0, (long long)a);
+    __m128i y = _mm_set_epi64x(0, (long long)b);
+    __m128i r;
+    switch (op) {
+    case LANE_ADD:
+        r = LANE_PICK(lane, _mm_add_epi8(x, y), _mm_add_epi16(x, y), _mm_add_epi32(x, y));
+        break;
+    case LANE_SUB:
+        r = LANE_PICK(lane, _mm_sub_epi8(x, y), _mm_sub_epi16(x, y), _mm_sub_epi32(x, y));
+        break;
+    case LANE_SAT_ADD:
+        if (lane == 32) {
+            return op_base(op, a, b, lane, is_signed);
+        }
+        r = is_signed ? LANE_PICK(lane, _mm_adds_epi8(x, y), _mm_adds_epi16(x, y), x) :
+            LANE_PICK(lane, _mm_adds_epu8(x, y), _mm_adds_epu16(x, y), x);
+        break;
+    case LANE_SAT_SUB:
+        if (lane == 32) {
+            return op_base(op, a, b, lane, is_signed);
+        }
+        r = is_signed ? LANE_PICK(lane, _mm_subs_epi8(x, y), _mm_subs_epi16(x, y), x) :
+            LANE_PICK(lane, _mm_subs_epu8(x, y), _mm_subs_epu16(x, y), x);
+        break;
+    case LANE_MIN:
+        r = is_signed ? LANE_PICK(lane, _mm_min_epi8(x, y), _mm_min_epi16(x, y), _mm_min_epi32(x, y)) :
+            LANE_PICK(lane, _mm_min_epu8(x, y), _mm_min_epu16(x, y), _mm_min_epu32(x, y));
+        break;
+    case LANE_MAX:
+        r = is_signed ? LANE_PICK(lane, _mm_max_epi8(x, y), _mm_max_epi16(x, y), _mm_max_epi32(x, y)) :
+            LANE_PICK(lane, _mm_max_epu8(x, y), _mm_max_epu16(x, y), _mm_max_epu32(x, y));
+        break;
+    case LANE_CMPEQ:
+        r = LANE_PICK(lane, _mm_cmpeq_epi8(x, y), _mm_cmpeq_epi16(x, y), _mm_cmpeq_epi32(x, y));
+        break;
+    case LANE_CMPGT:
+        if (!is_signed) {
+            // unsigned by moving both ranges down by the top bit
+            __m128i bias = _mm_set1_epi64x((long long)lane_top(lane));
+            x = _mm_xor_si128(x, bias);
+            y = _mm_xor_si128(y, bias);
+        }
+        r = LANE_PICK(lane, _mm_cmpgt_epi8(x, y), _mm_cmpgt_epi16(x, y), _mm_cmpgt_epi32(x, y));
+        break;
+    default:
+        return 0;
+    }
+    uint64_t out;
+    _mm_storel_epi64((__m128i *)&out, r);
+    return out;
+}
+
+__attribute__((target("ssse3")))
+static uint64_t shuffle_sse(uint64_t a, uint64_t sel) noexcept {
+    __m128i x = _mm_set_epi64x(0, (long long)a);
+    __m128i s = _mm_set_epi64x(0, (long long)(sel & 0x8787878787878787)); // the low 8 bytes only
+    uint64_t out;
+    _mm_storel_epi64((__m128i *)&out, _mm_shuffle_epi8(x, s));
+    return out;
+}
+
+#undef LANE_PICK
+#endif
+
+LaneKernels lane_kernels(unsigned features) noexcept {
+    LaneKernels kernels = {op_base, shuffle_base, "swar"};
+#ifdef CPU_X86
+    if (features & CPU_SSE41) {
+        kernels = {op_sse, shuffle_sse, "sse4.1"};
+    }
+#else
+    (void)features;
+#endif
+    return kernels;
+}
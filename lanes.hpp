@@ -0,0 +1,34 @@
+#ifndef HD_LANES_H
+#define HD_LANES_H
+
+#include <stdint.h>
+
+/**
+ * Lane kernels of the lane operators, a 64 bit word as 8 lanes of 8 bits,
+ * 4 of 16 or 2 of 32, lane 0 lowest as in an MMX or SSE register. The base
+ * variant is SWAR, word arithmetic with the carries kept in their lanes,
+ * the SSE one the packed instruction of each operation. Both give the same
+ * results.
+ */
+
+enum LaneOp {
+    LANE_ADD,
+    LANE_SUB,
+    LANE_SAT_ADD,
+    LANE_SAT_SUB,
+    LANE_MIN,
+    LANE_MAX,
+    LANE_CMPEQ, // all ones in the lanes that compare, zeros in the rest
+    LANE_CMPGT,
+};
+
+struct LaneKernels {
+    uint64_t (* op)(LaneOp op, uint64_t a, uint64_t b, unsigned lane, bool is_signed); // lane 8, 16 or 32
+    uint64_t (* shuffle)(uint64_t a, uint64_t sel); // pshufb, the byte of a at each byte of sel & 7, 0 for bit 7
+    const char *name;
+};
+
+// the fastest variants for features, a mask of CpuFeature
+LaneKernels lane_kernels(unsigned features) noexcept;
+
+#endif // HD_LANES_H
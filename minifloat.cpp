@@ -0,0 +1,287 @@
+#include <math.h>
+#include <string.h>
+
+#include "cpu.hpp"
+#include "minifloat.hpp"
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+static uint32_t float_bits(float value) noexcept {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits) noexcept {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * A double to an IEEE style float of exp_bits and mant_bits, one rounding
+ * by nearbyint() in the default to nearest even mode
+ */
+static uint32_t mini_from_double(double value, int exp_bits, int mant_bits) noexcept {
+    uint32_t sign = signbit(value) ? (uint32_t)1 << (exp_bits + mant_bits) : 0;
+    uint32_t exp_max = ((uint32_t)1 << exp_bits) - 1;
+    uint32_t one = (uint32_t)1 << mant_bits;
+    int bias = (1 << (exp_bits - 1)) - 1;
+
+    if (isnan(value)) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint32_t payload = (uint32_t)((bits & 0xFFFFFFFFFFFFF) >> (52 - mant_bits));
+        return sign | exp_max << mant_bits | one >> 1 | payload;
+    }
+    value = fabs(value);
+    if (isinf(value)) {
+        return sign | exp_max << mant_bits;
+    }
+    if (value == 0) {
+        return sign;
+    }
+
+    int e;
+    frexp(value, &e);
+    int exp = e - 1 + bias;
+    if (exp < 1) {
+        // subnormal, a carry into the exponent gives the smallest normal
+        return sign | (uint32_t)nearbyint(ldexp(value, mant_bits - 1 + bias));
+    }
+    uint32_t mant = (uint32_t)nearbyint(ldexp(value, mant_bits - e + 1));
+    if (mant == one << 1) {
+        mant = one;
+        exp++;
+    }
+    if (exp >= (int)exp_max) {
+        return sign | exp_max << mant_bits;
+    }
+    return sign | (uint32_t)exp << mant_bits | (mant - one);
+}
+
+static float half_to_float_base(uint16_t half) noexcept {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exp = (half >> 10) & 0x1F;
+    uint32_t mant = half & 0x3FF;
+
+    if (exp == 0x1F) {
+        return bits_float(sign | 0x7F800000 | (mant ? 0x400000 | mant << 13 : 0));
+    }
+    if (exp == 0) {
+        // subnormal, exact in float
+        float value = (float)mant * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+    return bits_float(sign | (exp + 112) << 23 | mant << 13);
+}
+
+static uint16_t half_from_float_base(float value) noexcept {
+    return (uint16_t)mini_from_double(value, 5, 10);
+}
+
+static void half_to_float_n_base(const uint16_t *src, float *dst, size_t count) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = half_to_float_base(src[i]);
+    }
+}
+
+#ifdef CPU_X86
+__attribute__((target("f16c")))
+static float half_to_float_f16c(uint16_t half) noexcept {
+    return _cvtsh_ss(half);
+}
+
+__attribute__((target("f16c")))
+static uint16_t half_from_float_f16c(float value) noexcept {
+    return _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+}
+
+__attribute__((target("avx,f16c")))
+static void half_to_float_n_f16c(const uint16_t *src, float *dst, size_t count) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i half = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+    }
+    for (; i < count; i++) {
+        dst[i] = _cvtsh_ss(src[i]);
+    }
+}
+#endif
+
+struct HalfKernels {
+    float (* to_float)(uint16_t half);
+    uint16_t (* from_float)(float value);
+    void (* to_float_n)(const uint16_t *src, float *dst, size_t count);
+};
+
+static HalfKernels half_select() noexcept {
+    HalfKernels kernels = {half_to_float_base, half_from_float_base, half_to_float_n_base};
+    const char *name = "base";
+#ifdef CPU_X86
+    if (cpu_features() & CPU_F16C) {
+        kernels = {half_to_float_f16c, half_from_float_f16c, half_to_float_n_f16c};
+        name = "f16c";
+    }
+#endif
+    cpu_select("fp16", name);
+    return kernels;
+}
+
+static const HalfKernels half_kernels = half_select();
+
+float half_to_float(uint16_t half) noexcept {
+    return half_kernels.to_float(half);
+}
+
+uint16_t half_from_float(float value) noexcept {
+    return half_kernels.from_float(value);
+}
+
+uint16_t half_from_double(double value) noexcept {
+    // one rounding either way when the double is a float already
+    if ((double)(float)value == value) {
+        return half_kernels.from_float((float)value);
+    }
+    return (uint16_t)mini_from_double(value, 5, 10);
+}
+
+void half_to_float_n(const uint16_t *src, float *dst, size_t count) noexcept {
+    half_kernels.to_float_n(src, dst, count);
+}
+
+// the top half of a float32
+float bf16_to_float(uint16_t bf16) noexcept {
+    return bits_float((uint32_t)bf16 << 16);
+}
+
+uint16_t bf16_from_float(float value) noexcept {
+    uint32_t bits = float_bits(value);
+    if (isnan(value)) {
+        return (uint16_t)(bits >> 16 | 0x40);
+    }
+    return (uint16_t)((bits + 0x7FFF + (bits >> 16 & 1)) >> 16);
+}
+
+uint16_t bf16_from_double(double value) noexcept {
+    if ((double)(float)value == value) {
+        return bf16_from_float((float)value);
+    }
+    return (uint16_t)mini_from_double(value, 8, 7);
+}
+
+void bf16_to_float_n(const uint16_t *src, float *dst, size_t count) noexcept {
+    size_t i = 0;
+#if defined(CPU_X86) && defined(__SSE2__)
+    // interleaved under zeros each is the top of a float, 8 per step
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        __m128i bf16 = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(zero, bf16));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(zero, bf16));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = bf16_to_float(src[i]);
+    }
+}
+
+/**
+ * FP8 by tables of its 256 values. Codes of one sign grow with the
+ * magnitude, so encoding counts the midpoints between neighbours below a
+ * value by binary search, one past the largest finite is where it
+ * overflows to inf or NaN.
+ */
+
+struct Fp8Table {
+    float decode[256];
+    float midpoint[128]; // between the magnitudes of codes i and i + 1
+    unsigned count; // of midpoints, the code past the last is the overflow
+    uint8_t nan;
+};
+
+static Fp8Table fp8_build(bool e5m2) noexcept {
+    Fp8Table table;
+    int mant_bits = e5m2 ? 2 : 3;
+    int bias = e5m2 ? 15 : 7;
+    unsigned exp_max = e5m2 ? 0x1F : 0xF;
+
+    for (unsigned code = 0; code < 256; code++) {
+        unsigned exp = (code >> mant_bits) & exp_max;
+        unsigned mant = code & ((1u << mant_bits) - 1);
+        float value;
+        if (e5m2 && exp == exp_max) {
+            value = mant ? NAN : INFINITY;
+        }
+        else if (!e5m2 && exp == exp_max && mant == 7) {
+            value = NAN;
+        }
+        else if (exp == 0) {
+            value = ldexpf((float)mant, 1 - bias - mant_bits);
+        }
+        else {
+            value = ldexpf((float)(mant | 1u << mant_bits), (int)exp - bias - mant_bits);
+        }
+        table.decode[code] = code & 0x80 ? -value : value;
+    }
+
+    // the largest finite and the code overflow goes to, at a step of its ulp
+    unsigned largest = e5m2 ? 0x7B : 0x7E;
+    table.count = largest + 1;
+    for (unsigned code = 0; code < largest; code++) {
+        table.midpoint[code] = (table.decode[code] + table.decode[code + 1]) / 2;
+    }
+    float ulp = table.decode[largest] - table.decode[largest - 1];
+    table.midpoint[largest] = table.decode[largest] + ulp / 2;
+    table.nan = e5m2 ? 0x7E : 0x7F;
+    return table;
+}
+
+static const Fp8Table& fp8_table(bool e5m2) noexcept {
+    static const Fp8Table e4m3_table = fp8_build(false);
+    static const Fp8Table e5m2_table = fp8_build(true);
+    return e5m2 ? e5m2_table : e4m3_table;
+}
+
+float fp8_to_float(uint8_t fp8, bool e5m2) noexcept {
+    return fp8_table(e5m2).decode[fp8];
+}
+
+uint8_t fp8_from_double(double value, bool e5m2) noexcept {
+    const Fp8Table& table = fp8_table(e5m2);
+    if (isnan(value)) {
+        return table.nan;
+    }
+    uint8_t sign = signbit(value) ? 0x80 : 0;
+    double magnitude = fabs(value);
+
+    // the count of midpoints below, a tie goes to the even code
+    unsigned lo = 0, hi = table.count;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (table.midpoint[mid] < magnitude) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    if (lo < table.count && table.midpoint[lo] == magnitude && (lo & 1)) {
+        lo++;
+    }
+    // E5M2 overflows to its inf, the code after the largest, E4M3 to NaN
+    if (lo == table.count && !e5m2) {
+        return table.nan | sign;
+    }
+    return (uint8_t)(lo | sign);
+}
+
+void fp8_to_float_n(const uint8_t *src, float *dst, size_t count, bool e5m2) noexcept {
+    const float *decode = fp8_table(e5m2).decode;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = decode[src[i]];
+    }
+}
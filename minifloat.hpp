@@ -0,0 +1,32 @@
+#ifndef HD_MINIFLOAT_H
+#define HD_MINIFLOAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Floats narrower than float32: IEEE binary16 (half), bfloat16 and the OCP
+ * FP8 formats E4M3 and E5M2, as their bits. Encoding rounds to nearest
+ * even straight from the source, a double isn't rounded to float first.
+ * NaNs of 16 bits keep the top of their payload and come out quiet, as
+ * F16C makes them.
+ */
+
+float half_to_float(uint16_t half) noexcept;
+uint16_t half_from_float(float value) noexcept;
+uint16_t half_from_double(double value) noexcept;
+
+float bf16_to_float(uint16_t bf16) noexcept;
+uint16_t bf16_from_float(float value) noexcept;
+uint16_t bf16_from_double(double value) noexcept;
+
+// count values at once, F16C converts 8 per instruction
+void half_to_float_n(const uint16_t *src, float *dst, size_t count) noexcept;
+void bf16_to_float_n(const uint16_t *src, float *dst, size_t count) noexcept;
+
+// E4M3 has no infinities, past 464 is NaN, E5M2 is IEEE like
+float fp8_to_float(uint8_t fp8, bool e5m2) noexcept;
+uint8_t fp8_from_double(double value, bool e5m2) noexcept;
+void fp8_to_float_n(const uint8_t *src, float *dst, size_t count, bool e5m2) noexcept;
+
+#endif // HD_MINIFLOAT_H
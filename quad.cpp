@@ -0,0 +1,159 @@
+#include <string.h>
+
+#include "quad.hpp"
+
+#ifdef HD_QUAD
+
+#define QUAD_MAX (~(quad_uint)0)
+#define TEN19 10000000000000000000ull // the largest power of 10 of 64 bits
+
+static unsigned shift_of(unsigned base) noexcept {
+    return base == 16 ? 4 : base == 8 ? 3 : 1;
+}
+
+static unsigned digit_of(char c) noexcept {
+    if ('0' <= c && c <= '9') return (unsigned)(c - '0');
+    if ('a' <= c && c <= 'f') return (unsigned)(c - 'a' + 10);
+    if ('A' <= c && c <= 'F') return (unsigned)(c - 'A' + 10);
+    return 16;
+}
+
+static unsigned trailing_zeros(quad_uint value) noexcept {
+    uint64_t low = (uint64_t)value;
+    return low ? (unsigned)__builtin_ctzll(low) : 64 + (unsigned)__builtin_ctzll((uint64_t)(value >> 64));
+}
+
+QuadText quad_text(quad_uint value, unsigned base, unsigned width) noexcept {
+    QuadText out;
+    char *end = &out.text[sizeof(out.text) - 1];
+    char *p = end;
+    *end = 0;
+
+    if (base == 10) {
+        while (value > UINT64_MAX) {
+            quad_uint quot = value / TEN19;
+            uint64_t chunk = (uint64_t)(value - quot * TEN19);
+            for (int i = 0; i < 19; i++) {
+                *--p = (char)('0' + chunk % 10);
+                chunk /= 10;
+            }
+            value = quot;
+        }
+        uint64_t low = (uint64_t)value;
+        do {
+            *--p = (char)('0' + low % 10);
+            low /= 10;
+        } while (low);
+    }
+    else {
+        unsigned shift = shift_of(base);
+        do {
+            *--p = "0123456789ABCDEF"[(unsigned)value & (base - 1)];
+            value >>= shift;
+        } while (value);
+    }
+
+    while ((size_t)(end - p) < width && p > &out.text[1]) {
+        *--p = '0';
+    }
+    memmove(out.text, p, (size_t)(end - p) + 1);
+    return out;
+}
+
+QuadText quad_text_signed(quad_int value) noexcept {
+    if (value >= 0) {
+        return quad_text((quad_uint)value, 10, 0);
+    }
+    QuadText out = quad_text((quad_uint)0 - (quad_uint)value, 10, 0);
+    memmove(&out.text[1], out.text, strlen(out.text) + 1);
+    out.text[0] = '-';
+    return out;
+}
+
+QuadFloatText quad_float_text(quad_float value, int precision) noexcept {
+    QuadFloatText out;
+    quadmath_snprintf(out.text, sizeof(out.text), "%.*Qf", precision > 64 ? 64 : precision, value);
+    return out;
+}
+
+quad_uint quad_parse(const char *text, unsigned base) noexcept {
+    quad_uint value = 0;
+    if (base == 10) {
+        while (digit_of(*text) < 10) {
+            uint64_t chunk = 0;
+            uint64_t scale = 1;
+            for (int i = 0; i < 19 && digit_of(*text) < 10; i++, text++) {
+                chunk = chunk * 10 + digit_of(*text);
+                scale *= 10;
+            }
+            if (__builtin_mul_overflow(value, (quad_uint)scale, &value) ||
+                __builtin_add_overflow(value, (quad_uint)chunk, &value)) {
+                return QUAD_MAX;
+            }
+        }
+        return value;
+    }
+
+    unsigned shift = shift_of(base);
+    for (unsigned d; (d = digit_of(*text)) < base; text++) {
+        if (value >> (128 - shift)) {
+            return QUAD_MAX;
+        }
+        value = value << shift | d;
+    }
+    return value;
+}
+
+quad_int quad_parse_signed(const char *text) noexcept {
+    bool neg = text[0] == '-';
+    if (text[0] == '-' || text[0] == '+') {
+        text++;
+    }
+    quad_uint limit = (QUAD_MAX >> 1) + neg;
+    quad_uint mag = quad_parse(text, 10);
+    if (mag > limit) {
+        mag = limit;
+    }
+    return neg ? (quad_int)((quad_uint)0 - mag) : (quad_int)mag;
+}
+
+quad_float quad_parse_float(const char *text, char **end) noexcept {
+    return strtoflt128(text, end);
+}
+
+// binary, the common factor of 2 first then the odd parts by subtraction
+quad_uint quad_gcd(quad_uint a, quad_uint b) noexcept {
+    if (!a || !b) {
+        return a | b;
+    }
+    unsigned shift = trailing_zeros(a | b);
+    a >>= trailing_zeros(a);
+    do {
+        b >>= trailing_zeros(b);
+        if (a > b) {
+            quad_uint t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    } while (b);
+    return a << shift;
+}
+
+quad_uint quad_lcm(quad_uint a, quad_uint b) noexcept {
+    return a && b ? a / quad_gcd(a, b) * b : 0;
+}
+
+quad_uint quad_pow(quad_uint base, quad_uint exp) noexcept {
+    quad_uint result = 1;
+    while (exp) {
+        if (exp & 1) {
+            result *= base;
+        }
+        exp >>= 1;
+        base *= base;
+    }
+    return result;
+}
+
+#endif // HD_QUAD
@@ -0,0 +1,60 @@
+#ifndef HD_QUAD_H
+#define HD_QUAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Words of 'hd --128', integers of the compiler's __int128 and IEEE binary128
+ * floats of __float128 with libquadmath for their functions
+ *
+ * printf and strto* know neither, words are converted to and from text here.
+ * Decimal goes through 64 bit chunks of 19 digits, so a word takes two 128
+ * bit divisions or multiplies at most instead of one a digit. Texts are
+ * returned in a struct, its buffer lives to the end of the caller's
+ * expression like 'printf("%s", quad_text(v, 16, 0).text)'.
+ */
+
+#if defined(__SIZEOF_INT128__) && defined(__SIZEOF_FLOAT128__) && __has_include(<quadmath.h>)
+#  define HD_QUAD
+#endif
+
+#ifdef HD_QUAD
+
+#include <quadmath.h>
+
+typedef __int128 quad_int;
+typedef unsigned __int128 quad_uint;
+typedef __float128 quad_float;
+
+struct QuadText {
+    char text[132]; // 128 binary digits, a sign and NUL
+};
+
+struct QuadFloatText {
+    char text[5008]; // the 4933 integer digits of the largest, a fraction of 64
+};
+
+// digits in base 2, 8, 10 or 16, zero padded to width
+QuadText quad_text(quad_uint value, unsigned base, unsigned width) noexcept;
+// decimal digits with a '-' ahead of a negative value
+QuadText quad_text_signed(quad_int value) noexcept;
+// like printf "%.*f", precision up to 64
+QuadFloatText quad_float_text(quad_float value, int precision) noexcept;
+
+// digits of base 2, 8, 10 or 16 up to the first that isn't one, saturating
+// like strtoull
+quad_uint quad_parse(const char *text, unsigned base) noexcept;
+// an optional sign then decimal digits, saturating like strtoll
+quad_int quad_parse_signed(const char *text) noexcept;
+// like strtod, end may be NULL
+quad_float quad_parse_float(const char *text, char **end) noexcept;
+
+quad_uint quad_gcd(quad_uint a, quad_uint b) noexcept;
+quad_uint quad_lcm(quad_uint a, quad_uint b) noexcept;
+// base^exp wrapping past the word
+quad_uint quad_pow(quad_uint base, quad_uint exp) noexcept;
+
+#endif // HD_QUAD
+
+#endif // HD_QUAD_H
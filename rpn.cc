@@ -4,21 +4,38 @@
 
 #if defined(RPN_8BITS)
 // https://en.wikipedia.org/wiki/Minifloat
-#define NO_FLOAT
-#define Float Int
+// https://www.opencompute.org/documents/ocp-8-bit-floating-point-specification-ofp8-revision-1-0-2023-12-01-pdf-1
 typedef int8_t Int;
 typedef uint8_t Uint;
+
+// OCP FP8, E4M3 or E5M2 with --fp8 e5m2, converted by tables and worked
+// on as float32
+struct Float8 {
+    Uint bits;
+
+    Float8() = default;
+    Float8(double value) noexcept :
+        bits{fp8_from_double(value, _fp8e5m2)}
+    {
+    }
+    operator float() const noexcept {
+        return fp8_to_float(bits, _fp8e5m2);
+    }
+};
+typedef Float8 Float;
+
 // windows complains but whatever it still works
-#define FMT_FLOAT "%hhi"
+#define FMT_FLOAT "%f"
 #define FMT_INT "%hhi"
 #define FMT_UINT "%hhu"
 #define FMT_HEX "%hhX"
 #define FMT_OCT "%hho"
+#define FMT_LONG_FLOAT "%.10f"
 #define FMT_LONG_HEX "%02hhX"
 #define FMT_LONG_OCT "%03hho"
 
-#define FLOAT_MOD(a, b) (a % b)
-#define FLOAT_POW(a, b) (Float)int_pow(a, b)
+#define FLOAT_MOD(...) (Float)fmodf(__VA_ARGS__)
+#define FLOAT_POW(...) (Float)powf(__VA_ARGS__)
 #define FLOAT_SQRT(...) (Float)sqrtf(__VA_ARGS__)
 #define FLOAT_SIN(...) (Float)sinf(__VA_ARGS__)
 #define FLOAT_COS(...) (Float)cosf(__VA_ARGS__)
@@ -33,39 +50,48 @@ typedef uint8_t Uint;
 #define FLOAT_TRUNC(...) (Float)truncf(__VA_ARGS__)
 #define FLOAT_LOG10(...) (Float)log10f(__VA_ARGS__)
 #define FLOAT_LOG(...) (Float)logf(__VA_ARGS__)
-#define FLOAT_ZERO 0
+#define FLOAT_ZERO 0.0f
 #define MY_INTMAX INT8_MAX
 #define MY_UINTMAX UINT8_MAX
-#define MY_FLOATMAX INT8_MAX
-#define MY_FLOATMIN 0
+#define MY_FLOATMAX (_fp8e5m2 ? 57344.0 : 448.0)
+#define MY_FLOATMIN (_fp8e5m2 ? 6.103515625e-05 : 0.015625)
 #define MY_BITMAX 7
-#define MY_FMANTMASK 0x7
-#define MY_FEXPMASK 0xF
-#define MY_FEXPBIT 3
-union FloatInfo { // on a Big Endian machine will need to convert to LE first
-    Float f;
-    struct {
-        Uint mantissa : 3;
-        Uint exponent : 4;
-        Uint sign : 1;
-    } parts;
-};
+#define MY_FMANTMASK (_fp8e5m2 ? 0x3 : 0x7)
+#define MY_FEXPMASK (_fp8e5m2 ? 0x1F : 0xF)
+#define MY_FEXPBIT (_fp8e5m2 ? 2 : 3)
 
 #elif defined(RPN_16BITS)
 // https://en.wikipedia.org/wiki/Half-precision_floating-point_format
-#define NO_FLOAT
-#define Float Int
+// https://en.wikipedia.org/wiki/Bfloat16_floating-point_format
 typedef int16_t Int;
 typedef uint16_t Uint;
-#define FMT_FLOAT "%hi"
+
+// IEEE binary16, or bfloat16 with --bf16, worked on as float32 which holds
+// more than twice their digits so results round back as if done in them
+struct Float16 {
+    Uint bits;
+
+    Float16() = default;
+    Float16(double value) noexcept :
+        bits{_bfloat16 ? bf16_from_double(value) : half_from_double(value)}
+    {
+    }
+    operator float() const noexcept {
+        return _bfloat16 ? bf16_to_float(bits) : half_to_float(bits);
+    }
+};
+typedef Float16 Float;
+
+#define FMT_FLOAT "%f"
 #define FMT_INT "%hi"
 #define FMT_UINT "%hu"
 #define FMT_HEX "%hX"
 #define FMT_OCT "%ho"
+#define FMT_LONG_FLOAT "%.10f"
 #define FMT_LONG_HEX "%04hX"
 #define FMT_LONG_OCT "%06ho"
-#define FLOAT_MOD(a, b) (a % b)
-#define FLOAT_POW(a, b) (Float)int_pow(a, b)
+#define FLOAT_MOD(...) (Float)fmodf(__VA_ARGS__)
+#define FLOAT_POW(...) (Float)powf(__VA_ARGS__)
 #define FLOAT_SQRT(...) (Float)sqrtf(__VA_ARGS__)
 #define FLOAT_SIN(...) (Float)sinf(__VA_ARGS__)
 #define FLOAT_COS(...) (Float)cosf(__VA_ARGS__)
@@ -80,23 +106,15 @@ typedef uint16_t Uint;
 #define FLOAT_TRUNC(...) (Float)truncf(__VA_ARGS__)
 #define FLOAT_LOG10(...) (Float)log10f(__VA_ARGS__)
 #define FLOAT_LOG(...) (Float)logf(__VA_ARGS__)
-#define FLOAT_ZERO 0
+#define FLOAT_ZERO 0.0f
 #define MY_INTMAX INT16_MAX
 #define MY_UINTMAX UINT16_MAX
-#define MY_FLOATMAX INT16_MAX
-#define MY_FLOATMIN 0
+#define MY_FLOATMAX (_bfloat16 ? 3.38953139e38 : 65504.0)
+#define MY_FLOATMIN (_bfloat16 ? 1.17549435e-38 : 6.103515625e-05)
 #define MY_BITMAX 15
-#define MY_FMANTMASK 0x3FF
-#define MY_FEXPMASK 0x1F
-#define MY_FEXPBIT 10
-union FloatInfo { // on a Big Endian machine will need to convert to LE first
-    Float f;
-    struct {
-        Uint mantissa : 10;
-        Uint exponent : 5;
-        Uint sign : 1;
-    } parts;
-};
+#define MY_FMANTMASK (_bfloat16 ? 0x7F : 0x3FF)
+#define MY_FEXPMASK (_bfloat16 ? 0xFF : 0x1F)
+#define MY_FEXPBIT (_bfloat16 ? 7 : 10)
 
 #elif defined(RPN_32BITS)
 typedef float Float;
@@ -135,14 +153,6 @@ typedef uint32_t Uint;
 #define MY_FMANTMASK 0x7FFFFF
 #define MY_FEXPMASK 0xFF
 #define MY_FEXPBIT 23
-union FloatInfo { // on a Big Endian machine will need to convert to LE first
-    Float f;
-    struct {
-        Uint mantissa : 23;
-        Uint exponent : 8;
-        Uint sign : 1;
-    } parts;
-};
 
 #elif defined(RPN_64BITS)
 typedef double Float;
@@ -155,8 +165,8 @@ typedef uint64_t Uint;
 #  define FMT_HEX "%llX"
 #  define FMT_OCT "%llo"
 #  define FMT_LONG_FLOAT "%.20lf"
-#  define FMT_LONG_HEX "%016llX"
-#  define FMT_LONG_OCT "%022llo"
+#  define FMT_LONG_HEX "%0*llX"
+#  define FMT_LONG_OCT "%0*llo"
 #elif defined(WIN32) || defined(_WIN32)
 #  define FMT_FLOAT "%lf"
 #  define FMT_INT "%I64i"
@@ -164,8 +174,8 @@ typedef uint64_t Uint;
 #  define FMT_HEX "%I64X"
 #  define FMT_OCT "%I64o"
 #  define FMT_LONG_FLOAT "%.20lf"
-#  define FMT_LONG_HEX "%016I64X"
-#  define FMT_LONG_OCT "%022I64o"
+#  define FMT_LONG_HEX "%0*I64X"
+#  define FMT_LONG_OCT "%0*I64o"
 #else
 #  define FMT_FLOAT "%lf"
 #  define FMT_INT "%li"
@@ -173,8 +183,8 @@ typedef uint64_t Uint;
 #  define FMT_HEX "%lX"
 #  define FMT_OCT "%lo"
 #  define FMT_LONG_FLOAT "%.20lf"
-#  define FMT_LONG_HEX "%016lX"
-#  define FMT_LONG_OCT "%022lo"
+#  define FMT_LONG_HEX "%0*lX"
+#  define FMT_LONG_OCT "%0*lo"
 #endif
 #define FLOAT_MOD(...) (Float)fmod(__VA_ARGS__)
 #define FLOAT_POW(...) (Float)pow(__VA_ARGS__)
@@ -193,74 +203,130 @@ typedef uint64_t Uint;
 #define FLOAT_LOG10(...) (Float)log10(__VA_ARGS__)
 #define FLOAT_LOG(...) (Float)log(__VA_ARGS__)
 #define FLOAT_ZERO 0.0
-#define MY_INTMAX INT64_MAX
-#define MY_UINTMAX UINT64_MAX
+// 'hd --bits' narrows the word at runtime, ints keep copies of its sign bit
+// past it, floats are doubles still
+#define MY_INTMAX (INT64_MAX >> (63 - MY_BITMAX))
+#define MY_UINTMAX (UINT64_MAX >> (63 - MY_BITMAX))
 #define MY_FLOATMAX __DBL_MAX__
 #define MY_FLOATMIN __DBL_MIN__
-#define MY_BITMAX 63
+#define MY_BITMAX (_bits ? (int)_bits - 1 : 63)
+#define WORD_MASK(u) ((u) & MY_UINTMAX)
+#define LONG_HEX_ARG(u) (int)((WORD_BITS + 3) / 4), (u)
+#define LONG_OCT_ARG(u) (int)((WORD_BITS + 2) / 3), (u)
 #define MY_FMANTMASK 0xFFFFFFFFFFFFF
 #define MY_FEXPMASK 0x7FF
 #define MY_FEXPBIT 52
-union FloatInfo {
-    Float f;
-    struct {
-        Uint mantissa : 52;
-        Uint exponent : 11;
-        Uint sign : 1;
-    } parts;
-};
+
+#elif defined(RPN_128BITS)
+// https://en.wikipedia.org/wiki/Quadruple-precision_floating-point_format
+typedef quad_float Float;
+typedef quad_int Int;
+typedef quad_uint Uint;
+
+// printf knows no 128 bit words, each is made text by its *_ARG
+#define FMT_FLOAT "%s"
+#define FMT_INT "%s"
+#define FMT_UINT "%s"
+#define FMT_HEX "%s"
+#define FMT_OCT "%s"
+#define FMT_LONG_FLOAT "%s"
+#define FMT_LONG_HEX "%s"
+#define FMT_LONG_OCT "%s"
+#define FLOAT_ARG(f) quad_float_text((f), 6).text
+#define INT_ARG(i) quad_text_signed(i).text
+#define UINT_ARG(u) quad_text((u), 10, 0).text
+#define HEX_ARG(u) quad_text((u), 16, 0).text
+#define OCT_ARG(u) quad_text((u), 8, 0).text
+#define LONG_FLOAT_ARG(f) quad_float_text((f), 36).text
+#define LONG_HEX_ARG(u) quad_text((u), 16, 32).text
+#define LONG_OCT_ARG(u) quad_text((u), 8, 43).text
+
+#define PARSE_FLOAT(s, end) quad_parse_float((s), (end))
+#define PARSE_INT(s) quad_parse_signed(s)
+#define PARSE_UINT(s, base) quad_parse((s), (base))
+#define WORD_GCD(a, b) quad_gcd((Uint)(a), (Uint)(b))
+#define WORD_LCM(a, b) quad_lcm((Uint)(a), (Uint)(b))
+#define WORD_POW(a, b) quad_pow((Uint)(a), (Uint)(b))
+
+#define FLOAT_MOD(...) (Float)fmodq(__VA_ARGS__)
+#define FLOAT_POW(...) (Float)powq(__VA_ARGS__)
+#define FLOAT_SQRT(...) (Float)sqrtq(__VA_ARGS__)
+#define FLOAT_SIN(...) (Float)sinq(__VA_ARGS__)
+#define FLOAT_COS(...) (Float)cosq(__VA_ARGS__)
+#define FLOAT_TAN(...) (Float)tanq(__VA_ARGS__)
+#define FLOAT_ASIN(...) (Float)asinq(__VA_ARGS__)
+#define FLOAT_ACOS(...) (Float)acosq(__VA_ARGS__)
+#define FLOAT_ATAN(...) (Float)atanq(__VA_ARGS__)
+#define FLOAT_ATAN2(...) (Float)atan2q(__VA_ARGS__)
+#define FLOAT_FLOOR(...) (Float)floorq(__VA_ARGS__)
+#define FLOAT_CEIL(...) (Float)ceilq(__VA_ARGS__)
+#define FLOAT_TRUNC(...) (Float)truncq(__VA_ARGS__)
+#define FLOAT_ROUND(...) (Float)roundq(__VA_ARGS__)
+#define FLOAT_LOG10(...) (Float)log10q(__VA_ARGS__)
+#define FLOAT_LOG(...) (Float)logq(__VA_ARGS__)
+#define FLOAT_ZERO ((Float)0)
+// the Q suffix of quadmath.h's constants needs GNU C++, these parse once
+#define FLOAT_PI quad_parse_float("3.14159265358979323846264338327950288", NULL)
+#define FLOAT_E quad_parse_float("2.71828182845904523536028747135266250", NULL)
+#define MY_INTMAX ((Int)(~(Uint)0 >> 1))
+#define MY_UINTMAX (~(Uint)0)
+#define MY_FLOATMAX quad_parse_float("1.18973149535723176508575932662800702e4932", NULL)
+#define MY_FLOATMIN quad_parse_float("3.36210314311209350626267781732175260e-4932", NULL)
+#define MY_BITMAX 127
+#define MY_FMANTMASK (((Uint)1 << 112) - 1)
+#define MY_FEXPMASK 0x7FFF
+#define MY_FEXPBIT 112
 #endif
 #define FMT_STRING "%s"
 
-#define MYMAX(a, b) ((a > b) ? (a) : (b))
-#define MYMIN(a, b) ((a < b) ? (a) : (b))
-
-// order of precedence, lowest to highest
-enum Type {
-    TYPE_INT,
-    TYPE_UINT,
-    TYPE_FLOAT,
-    TYPE_STRING,
-    TYPE_COUNT
-};
+// the printf arguments of the FMT_* formats, a float promoted to double as
+// float is but Float8 and Float16 aren't
+#ifndef FLOAT_ARG
+#define FLOAT_ARG(f) ((double)(f))
+#define INT_ARG(i) (i)
+#define UINT_ARG(u) (u)
+#define HEX_ARG(u) (u)
+#define OCT_ARG(u) (u)
+#define LONG_FLOAT_ARG(f) FLOAT_ARG(f)
+#endif
+#ifndef LONG_HEX_ARG
+#define LONG_HEX_ARG(u) (u)
+#define LONG_OCT_ARG(u) (u)
+#endif
+#ifndef WORD_MASK
+#define WORD_MASK(u) (u)
+#endif
 
-static const char *typeTable[] = {
-    "int",
-    "uint",
-    "float",
-    "string",
-    "",
-};
+// the 64 bit C library and util.hpp serve every width but 128, literals are
+// read by strto* then truncated to the width
+#ifndef PARSE_UINT
+#if defined(RPN_32BITS)
+#define PARSE_FLOAT(s, end) strtof((s), (end))
+#else
+#define PARSE_FLOAT(s, end) (Float)strtod((s), (end))
+#endif
+#define PARSE_INT(s) (Int)strtoll((s), NULL, 10)
+#define PARSE_UINT(s, base) (Uint)strtoull((s), NULL, (base))
+#define WORD_GCD(a, b) gcd((unsigned long)(a), (unsigned long)(b))
+#define WORD_LCM(a, b) lcm((unsigned long)(a), (unsigned long)(b))
+#define WORD_POW(a, b) int_pow((unsigned long)(a), (unsigned long)(b))
+#define FLOAT_PI M_PI
+#define FLOAT_E M_E
+#endif
 
-enum Format {
-    FORMAT_DEC,
-    FORMAT_HEX,
-    FORMAT_OCT,
-    FORMAT_BIN,
-    FORMAT_BIG,
-    FORMAT_LITTLE,
-    FORMAT_CHAR,
-    FORMAT_TYPE,
-    FORMAT_COUNT
-};
+#define MYMAX(a, b) ((a > b) ? (a) : (b))
+#define MYMIN(a, b) ((a < b) ? (a) : (b))
 
-static const char *formatTable[] = {
-    "dec",
-    "hex",
-    "oct",
-    "bin",
-    "big", // endianness
-    "little",
-    "chr",
-    "type",
-    "",
-};
+// bits of the word, the 64 bit builtins shift narrower ones to or from the top
+#define WORD_BITS ((Uint)(MY_BITMAX + 1))
+#define WORD_SHIFT (64 - (int)WORD_BITS)
 
 union Number {
     Int i;
     Uint u;
     Float f;
     const char *s;
+    const Big *b;
 };
 
 struct Value {
@@ -271,10 +337,9 @@ struct Value {
     Value() noexcept;
     Value(Int number) noexcept;
     Value(Uint number) noexcept;
-#ifndef NO_FLOAT
     Value(Float number) noexcept;
-#endif
     Value(const char *value) noexcept;
+    Value(const Big *value) noexcept;
 
     void print() noexcept;
     void println() noexcept;
@@ -286,20 +351,28 @@ struct Value {
     Value unexpected_type(void) noexcept;
 };
 
+struct ImageWriter;
+
 struct Node {
     virtual void exec(std::stack<Value>& stack) noexcept = 0;
+    virtual void save(ImageWriter& image) noexcept = 0;
+    virtual Node *clone() noexcept = 0;
     virtual ~Node() = default;
 };
 
 typedef Value (* SymOp)(void);
 typedef Value (* SymBinop)(Value& lhs, Value& rhs);
 typedef Value (* SymUnop)(Value& lhs);
+typedef Value (* SymNaryop)(Value *args); // the deepest operand first
+typedef void (* SymStackop)(std::stack<Value>& stack); // pops its operands, pushes any results
 
 struct SymNode : public Node {
     SymOp op;
 
     SymNode(SymOp op) noexcept;
     void exec(std::stack<Value>& stack) noexcept override;
+    void save(ImageWriter& image) noexcept override;
+    Node *clone() noexcept override;
 };
 
 struct NumNode : public Node {
@@ -307,13 +380,32 @@ struct NumNode : public Node {
 
     NumNode(Value value) noexcept;
     void exec(std::stack<Value>& stack) noexcept override;
+    void save(ImageWriter& image) noexcept override;
+    Node *clone() noexcept override;
+};
+
+// instructions and the interned string table of an image being written
+struct ImageWriter {
+    std::vector<ImageInsn> insns;
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> offsets;
+    std::unordered_map<SymOp, uint32_t> ops;
+
+    uint32_t op(SymOp op) noexcept;
+    uint32_t word(const char *text) noexcept;
 };
 
 static bool conve_binary(const char *value, Uint *out) noexcept;
 static void print_binary(Uint value) noexcept;
 static void print_reversed(Uint value) noexcept;
-
-static Node *node_new(char *value) noexcept;
+static void print_lanes(Value& v, unsigned lane, const char *end) noexcept;
+
+static bool literal_parse(const char *value, Value *out) noexcept;
+static const Big *big_of(Value& v) noexcept;
+static Value word_fit(Value v) noexcept;
+static Value maybe_a_constant(Value v) noexcept;
+[[noreturn]] static void int_overflow(const char *op, Type type) noexcept;
+static bool node_parse(const char *value, Node **out) noexcept;
 static void node_free(Node *self) noexcept;
 
 //static Value binop_none(Value& lhs, Value& rhs) noexcept;
@@ -343,6 +435,7 @@ static Value binop_cast(Value& lhs, Value& rhs) noexcept;
 static Value binop_pun(Value& lhs, Value& rhs) noexcept;
 static Value binop_gcd(Value& lhs, Value& rhs) noexcept;
 static Value binop_lcm(Value& lhs, Value& rhs) noexcept;
+static Value binop_invmod(Value& lhs, Value& rhs) noexcept;
 static Value binop_ror(Value& lhs, Value& rhs) noexcept;
 static Value binop_rol(Value& lhs, Value& rhs) noexcept;
 static Value binop_ncr(Value& lhs, Value& rhs) noexcept;
@@ -350,6 +443,37 @@ static Value binop_npr(Value& lhs, Value& rhs) noexcept;
 static Value binop_save(Value& val, Value& name) noexcept;
 static Value binop_max(Value& lhs, Value& rhs) noexcept;
 static Value binop_min(Value& lhs, Value& rhs) noexcept;
+static Value binop_pdep(Value& lhs, Value& rhs) noexcept;
+static Value binop_sext(Value& lhs, Value& rhs) noexcept;
+static Value binop_pext(Value& lhs, Value& rhs) noexcept;
+static Value binop_interleave(Value& lhs, Value& rhs) noexcept;
+static Value binop_deinterleave(Value& lhs, Value& rhs) noexcept;
+static Value binop_deinterleave3(Value& lhs, Value& rhs) noexcept;
+static Value binop_ladd8(Value& lhs, Value& rhs) noexcept;
+static Value binop_ladd16(Value& lhs, Value& rhs) noexcept;
+static Value binop_ladd32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsub8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsub16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsub32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_add8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_add16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_add32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_sub8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_sub16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lsat_sub32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmin8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmin16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmin32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmax8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmax16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lmax32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpeq8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpeq16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpeq32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpgt8(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpgt16(Value& lhs, Value& rhs) noexcept;
+static Value binop_lcmpgt32(Value& lhs, Value& rhs) noexcept;
+static Value binop_lshuf8(Value& lhs, Value& rhs) noexcept;
 
 static Value unop_not(Value& lhs) noexcept;
 static Value unop_inv(Value& lhs) noexcept;
@@ -387,8 +511,31 @@ static Value unop_factorial(Value &lhs) noexcept;
 static Value unop_inverse(Value &lhs) noexcept;
 static Value unop_clearbits(Value &lhs) noexcept;
 static Value unop_setbits(Value &lhs) noexcept;
+static Value unop_clz(Value &lhs) noexcept;
+static Value unop_ctz(Value &lhs) noexcept;
+static Value unop_bswap(Value &lhs) noexcept;
+static Value unop_bitrev(Value &lhs) noexcept;
+static Value unop_parity(Value &lhs) noexcept;
+static Value unop_isprime(Value &lhs) noexcept;
+
+static Value naryop_addmod(Value *args) noexcept;
+static Value naryop_mulmod(Value *args) noexcept;
+static Value naryop_powmod(Value *args) noexcept;
+static Value naryop_fshl(Value *args) noexcept;
+static Value naryop_fshr(Value *args) noexcept;
+static Value naryop_extract(Value *args) noexcept;
+static Value naryop_insert(Value *args) noexcept;
+static Value naryop_interleave3(Value *args) noexcept;
+
+static void stackop_factor(std::stack<Value>& stack) noexcept;
+static void stackop_addf(std::stack<Value>& stack) noexcept;
+static void stackop_subf(std::stack<Value>& stack) noexcept;
+static void stackop_mulf(std::stack<Value>& stack) noexcept;
+static void stackop_shlf(std::stack<Value>& stack) noexcept;
 
 static bool op_isunary(SymOp op) noexcept;
+static bool op_isstackop(SymOp op) noexcept;
+static unsigned op_arity(SymOp op) noexcept;
 //static bool op_isbinary(SymOp op) noexcept;
 
 #if 0
@@ -455,198 +602,451 @@ static SymUnop unopTable[] = {
     unop_inverse,
     unop_clearbits,
     unop_setbits,
+    unop_clz,
+    unop_ctz,
+    unop_bswap,
+    unop_bitrev,
+    unop_parity,
+    unop_isprime,
     NULL,
 };
 
-#define XENTRY(Name, Op) {Name, (SymOp)Op}
+// operations pushing any number of results
+static SymStackop stackopTable[] = {
+    stackop_factor,
+    stackop_addf,
+    stackop_subf,
+    stackop_mulf,
+    stackop_shlf,
+    NULL,
+};
+
+// operations of more than two operands
+#define NARY_MAX 4
 static struct {
-    const char *name; SymOp op;
-} opLookup[] = {
-    XENTRY(REG_OP_ADD_SYM, binop_add),
-    XENTRY(REG_OP_ADD, binop_add),
-    XENTRY(REG_OP_SUB_SYM, binop_sub),
-    XENTRY(REG_OP_SUB, binop_sub),
-    XENTRY(REG_OP_MUL_SYM, binop_mul),
-    XENTRY(REG_OP_MUL, binop_mul),
-    XENTRY(REG_OP_DIV_SYM, binop_div),
-    XENTRY(REG_OP_DIV, binop_div),
-    XENTRY(REG_OP_MOD_SYM, binop_mod),
-    XENTRY(REG_OP_MOD, binop_mod),
-    XENTRY(REG_OP_BITXOR_SYM, binop_bitxor),
-    XENTRY(REG_OP_BITXOR, binop_bitxor),
-    XENTRY(REG_OP_BITAND_SYM, binop_bitand),
-    XENTRY(REG_OP_BITAND, binop_bitand),
-    XENTRY(REG_OP_BITOR_SYM, binop_bitor),
-    XENTRY(REG_OP_BITOR, binop_bitor),
-    XENTRY(REG_OP_BITCLEAR_SYM, binop_bitclear), // a & ~b
-    XENTRY(REG_OP_BITCLEAR, binop_bitclear),
-    XENTRY(REG_OP_NOT_SYM, unop_not),
-    XENTRY(REG_OP_NOT, unop_not),
-    XENTRY(REG_OP_INV_SYM, unop_inv),
-    XENTRY(REG_OP_INV, unop_inv),
-    XENTRY(REG_OP_AND_SYM, binop_and),
-    XENTRY(REG_OP_AND, binop_and),
-    XENTRY(REG_OP_OR_SYM, binop_or),
-    XENTRY(REG_OP_OR, binop_or),
-    XENTRY(REG_OP_XOR_SYM, binop_xor),
-    XENTRY(REG_OP_XOR, binop_xor),
-    XENTRY(REG_OP_POW_SYM, binop_pow),
-    XENTRY(REG_OP_POW, binop_pow),
-    XENTRY(REG_OP_SHL_SYM, binop_shl),
-    XENTRY(REG_OP_SHL, binop_shl),
-    XENTRY(REG_OP_LSH, binop_shl),
-    XENTRY(REG_OP_SHR_SYM, binop_shr),
-    XENTRY(REG_OP_SHR, binop_shr),
-    XENTRY(REG_OP_RSH, binop_shr),
-    XENTRY(REG_OP_EQ_SYM, binop_equ),
-    XENTRY(REG_OP_EQ, binop_equ),
-    XENTRY(REG_OP_EQU, binop_equ),
-    XENTRY(REG_OP_NEQ_SYM, binop_neq),
-    XENTRY(REG_OP_NEQ, binop_neq),
-    XENTRY(REG_OP_GT_SYM, binop_gt),
-    XENTRY(REG_OP_GT, binop_gt),
-    XENTRY(REG_OP_GTE_SYM, binop_gte),
-    XENTRY(REG_OP_GTE, binop_gte),
-    XENTRY(REG_OP_LT_SYM, binop_lt),
-    XENTRY(REG_OP_LT, binop_lt),
-    XENTRY(REG_OP_LTE_SYM, binop_lte),
-    XENTRY(REG_OP_LTE, binop_lte),
-    XENTRY(REG_OP_END_SYM, unop_end),
-    XENTRY(REG_OP_END, unop_end),
-    XENTRY(REG_OP_SEP_SYM, unop_sep),
-    XENTRY(REG_OP_SEP, unop_sep),
-    XENTRY(REG_OP_QUIET, unop_quiet),
-    XENTRY(REG_OP_CAST, binop_cast),
-    XENTRY(REG_OP_AS, binop_pun),
-    XENTRY(REG_OP_SQRT, unop_sqrt),
-    XENTRY(REG_OP_GCD, binop_gcd),
-    XENTRY(REG_OP_LCM, binop_lcm),
-    XENTRY(REG_OP_ROR, binop_ror),
-    XENTRY(REG_OP_ROL, binop_rol),
-    XENTRY(REG_OP_SIN, unop_sin),
-    XENTRY(REG_OP_COS, unop_cos),
-    XENTRY(REG_OP_TAN, unop_tan),
-    XENTRY(REG_OP_ASIN, unop_asin),
-    XENTRY(REG_OP_ACOS, unop_acos),
-    XENTRY(REG_OP_ATAN, unop_atan),
-    XENTRY(REG_OP_ATAN2, binop_atan2),
-    XENTRY(REG_OP_ABS, unop_abs), // to +
-    XENTRY(REG_OP_SGN, unop_sgn),
-    XENTRY(REG_OP_FLOOR, unop_floor),
-    XENTRY(REG_OP_ROUND, unop_round),
-    XENTRY(REG_OP_CEIL, unop_ceil),
-    XENTRY(REG_OP_TRUNC, unop_trunc),
-    XENTRY(REG_OP_ORD, unop_ord),
-    //XENTRY(REG_OP_CHR, unop_chr),
-    XENTRY(REG_OP_LN, unop_ln),
-    XENTRY(REG_OP_LOG, unop_log),
-    XENTRY(REG_OP_INFO, unop_info),
-    XENTRY(REG_OP_FSGN, unop_fsgn),
-    XENTRY(REG_OP_FEXP, unop_fexp),
-    XENTRY(REG_OP_FMANT, unop_fmant),
-    XENTRY(REG_OP_FACTORIAL, unop_factorial),
-    XENTRY(REG_OP_INVERSE, unop_inverse),
-    XENTRY(REG_OP_NCR, binop_ncr),
-    XENTRY(REG_OP_NPR, binop_npr),
-    XENTRY(REG_OP_SAVE, binop_save),
-    XENTRY(REG_OP_MAX, binop_max),
-    XENTRY(REG_OP_MIN, binop_min),
-    XENTRY(REG_OP_CLEARBITS, unop_clearbits),
-    XENTRY(REG_OP_SETBITS, unop_setbits),
-    XENTRY(NULL, NULL),
+    SymNaryop op;
+    unsigned arity;
+} naryTable[] = {
+    {naryop_addmod, 3},
+    {naryop_mulmod, 3},
+    {naryop_powmod, 3},
+    {naryop_fshl, 3},
+    {naryop_fshr, 3},
+    {naryop_extract, 3},
+    {naryop_insert, 4},
+    {naryop_interleave3, 3},
+    {NULL, 0},
+};
+
+// the function of each of opNames
+#define OP_ENTRY(Name, Op) (SymOp)Op,
+static const SymOp opTable[] = {
+    RPN_OPERATIONS(OP_ENTRY)
+    NULL,
 };
-#undef XENTRY
+#undef OP_ENTRY
 
 struct Variable {
     const char *name;
     Value value;
 };
 
-static std::vector<Variable> constants = {
-    {"pi", Value((Float)M_PI)},
-    {"%e", Value((Float)M_E)},
-    {"inf", Value((Float)INFINITY)},
-    {"-inf", Value((Float)-INFINITY)},
-    {"nan", Value((Float)NAN)},
-    {"true", Value((Int)1)},
-    {"false", Value((Int)0)},
-    {"intmax", Value((Int)MY_INTMAX)},
-    {"uintmax", Value((Uint)MY_UINTMAX)},
-    {"floatmax", Value((Float)MY_FLOATMAX)},
-    {"floatmin", Value((Float)MY_FLOATMIN)},
-    {"bitmax", Value((Int)MY_BITMAX)},
-    {"fmantmask", Value((Int)MY_FMANTMASK)},
-    {"fexpmask", Value((Int)MY_FEXPMASK)},
-    {"fexpbit", Value((Int)MY_FEXPBIT)},
-};
+// of constantTable, made on each lookup as the limits follow the options of
+// the run, '--bits' and the float formats
+static Value constant_of(size_t index) noexcept {
+    switch (index) {
+    case 0: return Value((Float)FLOAT_PI);
+    case 1: return Value((Float)FLOAT_E);
+    case 2: return Value((Float)INFINITY);
+    case 3: return Value((Float)-INFINITY);
+    case 4: return Value((Float)NAN);
+    case 5: return Value((Int)1);
+    case 6: return Value((Int)0);
+    case 7: return Value((Int)MY_INTMAX);
+    case 8: return Value((Uint)MY_UINTMAX);
+    case 9: return Value((Float)MY_FLOATMAX);
+    case 10: return Value((Float)MY_FLOATMIN);
+    case 11: return Value((Int)MY_BITMAX);
+    case 12: return Value((Int)MY_FMANTMASK);
+    case 13: return Value((Int)MY_FEXPMASK);
+    default: return Value((Int)MY_FEXPBIT);
+    }
+}
+
+// the float format of the word, as images and stores record it
+static uint8_t word_floats() noexcept {
+#if defined(RPN_16BITS)
+    return _bfloat16 ? IMAGE_FLOATS_BF16 : IMAGE_FLOATS_DEFAULT;
+#elif defined(RPN_8BITS)
+    return _fp8e5m2 ? IMAGE_FLOATS_E5M2 : IMAGE_FLOATS_DEFAULT;
+#else
+    return IMAGE_FLOATS_DEFAULT;
+#endif
+}
 
-static Value *constant_find(const char *name) noexcept {
+// saved by the program, shadowing constants, and dropped with its Rpn
+static thread_local std::vector<Variable> variables;
+
+static const Value *constant_find(const char *name) noexcept {
     assert(name);
-    for (auto& var : constants) {
+    for (auto& var : variables) {
         if (strcasecmp(name, var.name) == 0) {
             return &var.value;
         }
     }
+    static thread_local Value stored;
+    StoreValue entry;
+    if (_rpnstore && sizeof(Uint) <= sizeof(entry.value)) {
+        if (store_get(_rpnstore, sizeof(Uint) * 8, name, &entry) && entry.type < TYPE_STRING) {
+            if (entry.type == TYPE_FLOAT && entry.floats != word_floats()) {
+                EPRINT("%s: saved as floats of another format, see --bf16 and --fp8\n", name);
+                rpn_exit(1);
+            }
+            memcpy(&stored.number, &entry.value, sizeof(Uint));
+            stored.type = (Type)entry.type;
+            stored.fmt = (Format)entry.fmt;
+            stored = word_fit(stored);
+            return &stored;
+        }
+        if (errno == EBUSY) {
+            EPRINT("%s: store slot stuck mid write, saving the name again mends it\n", name);
+            rpn_exit(1);
+        }
+    }
+    static thread_local Value constant;
+    for (size_t i = 0; constantTable[i] != NULL; i++) {
+        if (strcasecmp(name, constantTable[i]) == 0) {
+            constant = constant_of(i);
+            return &constant;
+        }
+    }
     return NULL;
 }
 
 static void constant_save(const char *name, Value& val) noexcept {
     assert(name);
-    Value *v = constant_find(name);
-    if (v) {
-        *v = val;
-        return;
+    // strings point into this run's program and bigs into its pool, only
+    // numbers of a word outlive it, and words of 128 bits don't fit a slot
+    if (_rpnstore && val.type == TYPE_BIG) {
+        EPRINT("save: '%s' is a bigint, which doesn't fit the store\n", name);
+        rpn_exit(1);
+    }
+    if (_rpnstore && val.type < TYPE_STRING && sizeof(Uint) > sizeof(StoreValue::value)) {
+        EPRINT("save: '%s' is a word of %d bits, which doesn't fit the store\n", name, (int)sizeof(Uint) * 8);
+        rpn_exit(1);
+    }
+    if (_rpnstore && val.type < TYPE_STRING && sizeof(Uint) <= sizeof(StoreValue::value)) {
+        StoreValue entry = {0, (uint8_t)val.type, (uint8_t)val.fmt, word_floats()};
+        memcpy(&entry.value, &val.number, sizeof(Uint));
+        if (!store_put(_rpnstore, sizeof(Uint) * 8, name, &entry)) {
+            EPRINT("save: '%s' doesn't fit the store\n", name);
+            rpn_exit(1);
+        }
+    }
+    for (auto& var : variables) {
+        if (strcasecmp(name, var.name) == 0) {
+            var.value = val;
+            return;
+        }
     }
 
     Variable variable = {name, val};
-    constants.push_back(variable);
+    variables.push_back(variable);
 }
 
+// where push_token is within a 'def NAME ... enddef'
+enum Define {
+    DEFINE_NONE,
+    DEFINE_NAME,
+    DEFINE_BODY,
+};
+
 struct Rpn {
     std::stack<Value> stack;
     std::vector<Node *> nodes;
+    std::unordered_set<std::string> words; // text of words from push_token
+    std::string scratch;
+    std::unordered_map<std::string, std::vector<Node *>> macros;
+    std::vector<Node *> fragment; // body of the macro being defined
+    std::string defining;
+    Define define;
 
     Rpn() noexcept;
     ~Rpn() noexcept;
     void exec() noexcept;
     void push(char *value) noexcept;
+    void push_token(const char *token, size_t len) noexcept;
+    void push_node(std::vector<Node *>& out, Node *n) noexcept;
+    bool push_macro(std::vector<Node *>& out, const char *name) noexcept;
+    void compiled() noexcept;
+    void reset() noexcept;
+    bool save(FILE *file) noexcept;
+    bool load(const void *data, size_t size) noexcept;
+    void map(const void *data, size_t size, bool big_endian) noexcept;
 };
 
 Rpn::Rpn() noexcept :
     stack{},
-    nodes{}
+    nodes{},
+    words{},
+    scratch{},
+    macros{},
+    fragment{},
+    defining{},
+    define{DEFINE_NONE}
 {
-    assert(regex_is_initialized());
 }
 
 Rpn::~Rpn() noexcept {
+    this->reset();
+}
+
+// keep allocations for the next program
+void Rpn::reset() noexcept {
     for (Node *n : this->nodes) {
         node_free(n);
     }
+    this->nodes.clear();
+    for (auto& macro : this->macros) {
+        for (Node *n : macro.second) {
+            node_free(n);
+        }
+    }
+    this->macros.clear();
+    for (Node *n : this->fragment) {
+        node_free(n);
+    }
+    this->fragment.clear();
+    this->define = DEFINE_NONE;
+    while (!this->stack.empty()) {
+        this->stack.pop();
+    }
+    variables.clear();
+    this->words.clear();
+    big_release();
+}
+
+// the whole program has been pushed
+void Rpn::compiled() noexcept {
+    if (this->define != DEFINE_NONE) {
+        EPRINT("def: '%s' is missing enddef\n", this->defining.c_str());
+        rpn_exit(1);
+    }
 }
 
 void Rpn::exec() noexcept {
+    this->compiled();
     for (Node *n : this->nodes) {
         n->exec(this->stack);
     }
 }
 
+// a word of its bytes in the given order, those past len zeros
+static Uint word_load(const unsigned char *bytes, size_t len, bool big_endian) noexcept {
+    Uint word = 0;
+    for (size_t i = 0; i < len; i++) {
+        word |= (Uint)((Uint)bytes[i] << (8 * (big_endian ? sizeof(Uint) - 1 - i : i)));
+    }
+    return word;
+}
+
+// the program once for each word of data on a stack of just that word, as
+// a uint, the top after it printed a line each. A last partial word is
+// padded with zeros. The bigs of the results are freed, those of the
+// program's literals kept.
+void Rpn::map(const void *data, size_t size, bool big_endian) noexcept {
+    const unsigned char *bytes = (const unsigned char *)data;
+    this->compiled();
+    size_t mark = big_mark();
+    for (size_t at = 0; at < size; at += sizeof(Uint)) {
+        Uint word = word_load(&bytes[at], MYMIN(sizeof(Uint), size - at), big_endian);
+        while (!this->stack.empty()) {
+            this->stack.pop();
+        }
+        this->stack.push(word_fit(Value(word)));
+        for (Node *n : this->nodes) {
+            n->exec(this->stack);
+        }
+        if (!this->stack.empty()) {
+            Value& value = this->stack.top();
+            value = maybe_a_constant(value);
+            value.println();
+        }
+    }
+    big_release_to(mark);
+}
+
 void Rpn::push(char *value) noexcept {
     assert(value);
-    Node *n = node_new(value);
+    this->push_token(value, strlen(value));
+}
+
+void Rpn::push_node(std::vector<Node *>& out, Node *n) noexcept {
     if (!n) {
         EPRINT("stack: out of memory\n");
-        exit(ENOMEM);
+        rpn_exit(ENOMEM);
+    }
+    out.push_back(n);
+}
+
+// inline a copy of the macro's nodes, false when there is no such macro
+bool Rpn::push_macro(std::vector<Node *>& out, const char *name) noexcept {
+    auto it = this->macros.find(name);
+    if (it == this->macros.end()) {
+        return false;
+    }
+    for (Node *n : it->second) {
+        this->push_node(out, n->clone());
+    }
+    return true;
+}
+
+// the token is neither NUL terminated nor outlives the call, so words keep
+// one copy of each distinct text
+void Rpn::push_token(const char *token, size_t len) noexcept {
+    assert(token);
+    this->scratch.assign(token, len);
+    const char *text = this->scratch.c_str();
+    Value number;
+
+    // def NAME ... enddef, the body is compiled now and inlined on use
+    if (this->define == DEFINE_NAME) {
+        if (strcmp(text, REG_OP_DEF) == 0 || strcmp(text, REG_OP_ENDDEF) == 0 ||
+            literal_parse(text, &number) || op_find(text) >= 0) {
+            EPRINT("def: '%s' is not a valid name\n", text);
+            rpn_exit(1);
+        }
+        this->defining = this->scratch;
+        this->define = DEFINE_BODY;
+        return;
+    }
+    if (strcmp(text, REG_OP_DEF) == 0) {
+        if (this->define != DEFINE_NONE) {
+            EPRINT("def: '%s' is missing enddef\n", this->defining.c_str());
+            rpn_exit(1);
+        }
+        this->define = DEFINE_NAME;
+        return;
+    }
+    if (strcmp(text, REG_OP_ENDDEF) == 0) {
+        if (this->define != DEFINE_BODY) {
+            EPRINT("enddef: Missing def\n");
+            rpn_exit(1);
+        }
+        std::vector<Node *>& macro = this->macros[this->defining];
+        for (Node *n : macro) {
+            node_free(n);
+        }
+        macro.swap(this->fragment);
+        this->fragment.clear();
+        this->define = DEFINE_NONE;
+        return;
+    }
+
+    std::vector<Node *>& out = this->define == DEFINE_BODY ? this->fragment : this->nodes;
+    Node *n;
+    if (node_parse(text, &n)) {
+        this->push_node(out, n);
+    }
+    else if (!this->push_macro(out, text)) {
+        const char *word = this->words.insert(this->scratch).first->c_str();
+        this->push_node(out, (Node *) new (std::nothrow) NumNode(Value(word)));
+    }
+}
+
+// the nodes as an image, false with errno set when writing failed
+bool Rpn::save(FILE *file) noexcept {
+    this->compiled();
+
+    ImageWriter image;
+    image.insns.reserve(this->nodes.size());
+    for (Node *n : this->nodes) {
+        n->save(image);
+    }
+    if (image.insns.size() > UINT32_MAX || image.strings.size() > UINT32_MAX) {
+        EPRINT("compile: program too large\n");
+        rpn_exit(1);
+    }
+
+    ImageHeader header = {};
+    memcpy(header.magic, IMAGE_MAGIC, 4);
+    header.version = IMAGE_VERSION;
+    header.order = IMAGE_ORDER;
+    header.bits = (uint32_t)WORD_BITS;
+    header.floats = word_floats();
+    header.ops = op_fingerprint();
+    header.count = (uint32_t)image.insns.size();
+    header.strings = image.strings.size();
+
+    return fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(image.insns.data(), sizeof(ImageInsn), image.insns.size(), file) == image.insns.size() &&
+        fwrite(image.strings.data(), 1, image.strings.size(), file) == image.strings.size();
+}
+
+// nodes from an image, words point into it so it has to outlive the Rpn
+bool Rpn::load(const void *data, size_t size) noexcept {
+    const char *why = image_check(data, size);
+    const ImageHeader *header = (const ImageHeader *)data;
+    if (!why && header->bits != WORD_BITS) {
+        why = "compiled for another word size";
+    }
+    if (!why && header->floats != word_floats()) {
+        why = "compiled for floats of another format";
+    }
+    if (!why && header->ops != op_fingerprint()) {
+        why = "compiled by another version of hd";
+    }
+    if (why) {
+        EPRINT("image: %s\n", why);
+        return false;
+    }
+
+    const ImageInsn *insns = (const ImageInsn *)&header[1];
+    const char *strings = (const char *)&insns[header->count];
+    size_t ops = op_count();
+    this->nodes.reserve(this->nodes.size() + header->count);
+    for (uint32_t i = 0; i < header->count; i++) {
+        const ImageInsn& insn = insns[i];
+        Node *n;
+        if (insn.kind == IMAGE_OP && insn.arg < ops && opTable[insn.arg]) {
+            n = (Node *) new (std::nothrow) SymNode(opTable[insn.arg]);
+        }
+        else if (insn.kind == IMAGE_VALUE && insn.type == TYPE_STRING && insn.arg < header->strings) {
+            n = (Node *) new (std::nothrow) NumNode(Value(&strings[insn.arg]));
+        }
+        else if (insn.kind == IMAGE_VALUE && insn.type < TYPE_STRING && insn.fmt < FORMAT_COUNT) {
+            Value value;
+            memcpy(&value.number, &insn.imm, MYMIN(sizeof(Uint), sizeof(insn.imm)));
+            value.type = (Type)insn.type;
+            value.fmt = (Format)insn.fmt;
+            n = (Node *) new (std::nothrow) NumNode(value);
+        }
+        else if (insn.kind == IMAGE_WIDE && insn.type < TYPE_STRING && insn.fmt < FORMAT_COUNT &&
+                 insn.arg < header->strings) {
+            Value value;
+            value.number.u = PARSE_UINT(&strings[insn.arg], 16);
+            value.type = (Type)insn.type;
+            value.fmt = (Format)insn.fmt;
+            n = (Node *) new (std::nothrow) NumNode(value);
+        }
+        else {
+            EPRINT("image: corrupt instruction %u\n", (unsigned)i);
+            return false;
+        }
+        if (!n) {
+            EPRINT("stack: out of memory\n");
+            rpn_exit(ENOMEM);
+        }
+        this->nodes.push_back(n);
     }
-    this->nodes.push_back(n);
-    //rpn_print(this);
+    return true;
 }
 
 Rpn *rpn_create() noexcept {
     Rpn *self = new (std::nothrow) Rpn{};
     if (!self) {
         EPRINT("rpn: out of memory\n");
-        exit(ENOMEM);
+        rpn_exit(ENOMEM);
     }
 
     return self;
@@ -663,13 +1063,51 @@ void rpn_push(Rpn*self, char *value) noexcept {
     self->push(value);
 }
 
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept {
+    assert(self);
+    self->push_token(token, len);
+}
+
+bool rpn_save(Rpn *self, FILE *file) noexcept {
+    assert(self);
+    assert(file);
+    return self->save(file);
+}
+
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept {
+    assert(self);
+    return self->load(data, size);
+}
+
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept {
+    assert(self);
+    self->map(data, size, big_endian);
+}
+
+// a number narrowed to the word of 'hd --bits', an int sign extended from
+// its top bit. The fixed widths are all of their word.
+static Value word_fit(Value v) noexcept {
+#if defined(RPN_64BITS)
+    if (_bits) {
+        if (v.type == TYPE_UINT) {
+            v.number.u &= MY_UINTMAX;
+        }
+        else if (v.type == TYPE_INT) {
+            unsigned shift = 64 - _bits;
+            v.number.i = (Int)(v.number.u << shift) >> shift;
+        }
+    }
+#endif
+    return v;
+}
+
 static Value maybe_a_constant(Value v) noexcept {
     // not a string
     if (v.type != TYPE_STRING) {
         return v;
     }
 
-    Value *lookup = constant_find(v.number.s);
+    const Value *lookup = constant_find(v.number.s);
     // not a constant
     if (!lookup) {
         return v;
@@ -683,7 +1121,7 @@ void rpn_print(Rpn *self) noexcept {
     assert(self);
     if (self->stack.size() < 1) {
         EPRINT("print: Stack empty\n");
-        exit(1);
+        rpn_exit(1);
     }
 
     Value& value = self->stack.top();
@@ -696,151 +1134,182 @@ void rpn_destroy(Rpn *self) noexcept {
     delete self;
 }
 
-void rpn_help() noexcept {
-    size_t len;
-    printf("Operations can be binary or unary, following C-style convention\n");
-    printf("Special operations are 'end' or 'sep' which print a newline or space\n");
+void rpn_reset(Rpn *self) noexcept {
+    assert(self);
+    self->reset();
+}
 
-    printf("Format is space-seperated RPN (Reverse Polish Notation)\n\n\t");
-    len = 0;
-    for (int i = 0; opLookup[i].name != NULL; i++) {
-        if (len > 60) {
-            printf("\n\t");
-            len = 0;
-        }
-        printf("%s ", opLookup[i].name);
-        len += strlen(opLookup[i].name) + 1;
+// print a lone literal without building an Rpn, false if it is not one
+bool rpn_convert(char *value) noexcept {
+    assert(value);
+    Value number;
+    if (!literal_parse(value, &number)) {
+        return false;
     }
-    printf("\n\n");
+    number = word_fit(number);
+    number.println();
+    return true;
+}
 
-    printf("Types can be used as the rhs operand of 'as' or 'cast' operations\n\n\t");
-    for (int i = 0; i < TYPE_COUNT; i++) {
-        printf("%s ", typeTable[i]);
-    }
-    printf("\n\n");
+void rpn_help() noexcept {
+    help_print();
+}
 
-    printf("Formats must be the rhs operand of 'as' operations\n\n\t");
-    for (int i = 0; i < FORMAT_COUNT; i++) {
-        printf("%s ", formatTable[i]);
+// a decimal literal past the word as a big with --bigint, false when it
+// fits or without, when it clamps as before. Literals of fewer digits than
+// the bits * 3 / 10 always fit.
+static bool literal_big(const char *value, bool is_signed, Value *out) noexcept {
+    if (!_bigint || strlen(&value[is_signed]) <= (size_t)(MY_BITMAX * 3 / 10)) {
+        return false;
     }
-    printf("\n\n");
-
-    printf("Constants consist of\n\n\t");
-    len = 0;
-    for (size_t i = 0; i < constants.size(); i++) {
-        if (len > 60) {
-            printf("\n\t");
-            len = 0;
-        }
-        printf("%s ", constants[i].name);
-        len += strlen(constants[i].name) + 1;
+    const Big *big = big_from_decimal(value);
+    if (!big) {
+        return false;
     }
-    printf("\n");
-
-    fflush(stdout);
+    Value max = is_signed ? Value((Int)MY_INTMAX) : Value((Uint)MY_UINTMAX);
+    Value min = Value((Int)(-MY_INTMAX - 1));
+    if (big_cmp(big, big_of(max)) <= 0 && (!is_signed || big_cmp(big, big_of(min)) >= 0)) {
+        return false;
+    }
+    *out = Value(big);
+    return true;
 }
 
-static Node *node_new(char *value) noexcept {
+// numeric literals, false for anything else. Conversion is by the PARSE_*
+// of the width.
+static bool literal_parse(const char *value, Value *out) noexcept {
     assert(value);
+    assert(out);
+    char *end;
 
-    if (value[0] == 0) {
-        EPRINT("operation: <empty> does not exist\n");
-        exit(1);
+    // the common case first, REG_UNSIGNED in one pass
+    const char *p = value;
+    while (lex_isdigit(*p)) {
+        p++;
+    }
+    if (*p == 0 && p != value && (value[0] != '0' || value[1] == 0)) {
+        if (literal_big(value, false, out)) {
+            return true;
+        }
+        *out = Value(PARSE_UINT(value, 10));
+        out->format(FORMAT_HEX);
+        return true;
+    }
+    // every literal starts with a digit, sign, '.' or a hexadecimal letter
+    if (p == value && !lex_issign(*p) && *p != '.' && !lex_ishex(*p)) {
+        return false;
     }
 
     // floating point
-    if (std::regex_match(value, *regex_float)) {
-        Float number;
-        if (sscanf(value, FMT_FLOAT, &number) == 1) {
-            return (Node *) new (std::nothrow) NumNode(Value(number));
+    if (lex_float(value)) {
+        Float number = PARSE_FLOAT(value, &end);
+        if (end == value) {
+            return false;
         }
+        *out = Value(number);
+        return true;
     }
 
     // signed
-    else if (std::regex_match(value, *regex_signed)) {
-        Int number;
-        if (sscanf(value, FMT_INT, &number) == 1) {
-            Value tmp = Value(number);
-            tmp.format(FORMAT_HEX);
-            return (Node *) new (std::nothrow) NumNode(tmp);
+    if (lex_signed(value)) {
+        if (literal_big(value, true, out)) {
+            return true;
         }
+        *out = Value(PARSE_INT(value));
+        out->format(FORMAT_HEX);
+        return true;
     }
     // unsigned
-    else if (std::regex_match(value, *regex_unsigned)) {
-        Uint number;
-        if (sscanf(value, FMT_UINT, &number) == 1) {
-            Value tmp = Value(number);
-            tmp.format(FORMAT_HEX);
-            return (Node *) new (std::nothrow) NumNode(tmp);
+    if (lex_unsigned(value)) {
+        if (literal_big(value, false, out)) {
+            return true;
         }
+        *out = Value(PARSE_UINT(value, 10));
+        out->format(FORMAT_HEX);
+        return true;
     }
+
     // hexadecimal
-    else if (std::regex_match(value, *regex_hexadecimal)) {
-        Uint number;
-        if (sscanf(&value[2], FMT_HEX, &number) == 1) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_hexadecimal(value)) {
+        *out = Value(PARSE_UINT(&value[2], 16));
+        return true;
     }
-    else if (std::regex_match(value, *regex_hexadecimal_post)) {
-        Uint number;
-        if (sscanf(&value[0], FMT_HEX, &number) == 1) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_hexadecimal_post(value)) {
+        *out = Value(PARSE_UINT(&value[0], 16));
+        return true;
     }
 
     // octal
-    else if (std::regex_match(value, *regex_octal)) {
-        Uint number;
-        if (sscanf(&value[2], FMT_OCT, &number) == 1) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_octal(value)) {
+        *out = Value(PARSE_UINT(&value[2], 8));
+        return true;
     }
-    else if (std::regex_match(value, *regex_octal_pre)) {
-        Uint number;
-        if (sscanf(&value[1], FMT_OCT, &number) == 1) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_octal_pre(value)) {
+        *out = Value(PARSE_UINT(&value[1], 8));
+        return true;
     }
-    else if (std::regex_match(value, *regex_octal_post)) {
-        Uint number;
-        if (sscanf(&value[0], FMT_OCT, &number) == 1) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_octal_post(value)) {
+        *out = Value(PARSE_UINT(&value[0], 8));
+        return true;
     }
 
     // binary
-    else if (std::regex_match(value, *regex_binary)) {
-        Uint number;
-        if (conve_binary(&value[2], &number)) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    Uint number;
+    if (lex_binary(value) && conve_binary(&value[2], &number)) {
+        *out = Value(number);
+        return true;
     }
-    else if (std::regex_match(value, *regex_binary_post)) {
-        Uint number;
-        if (conve_binary(&value[0], &number)) {
-            Value tmp = Value(number);
-            return (Node *) new (std::nothrow) NumNode(tmp);
-        }
+    if (lex_binary_post(value) && conve_binary(&value[0], &number)) {
+        *out = Value(number);
+        return true;
     }
 
-    for (size_t i = 0; opLookup[i].name != NULL; i++) {
-        if (strcmp(opLookup[i].name, value) == 0) {
-            if (opLookup[i].op == NULL) {
-                EPRINT("operation: '%s' not implemented\n", opLookup[i].name);
-                exit(1);
-            }
-            return (Node *) new (std::nothrow) SymNode(opLookup[i].op);
+    return false;
+}
+
+// first index of the operation, aliases share it
+uint32_t ImageWriter::op(SymOp op) noexcept {
+    if (this->ops.empty()) {
+        for (uint32_t i = 0; opNames[i] != NULL; i++) {
+            this->ops.emplace(opTable[i], i);
         }
     }
+    return this->ops.at(op);
+}
+
+uint32_t ImageWriter::word(const char *text) noexcept {
+    auto it = this->offsets.emplace(text, (uint32_t)this->strings.size());
+    if (it.second) {
+        this->strings.append(text, strlen(text) + 1);
+    }
+    return it.first->second;
+}
+
+// a literal or an operation, false for a word. *out is NULL when out of memory.
+static bool node_parse(const char *value, Node **out) noexcept {
+    assert(value);
+
+    if (value[0] == 0) {
+        EPRINT("operation: <empty> does not exist\n");
+        rpn_exit(1);
+    }
+
+    Value number;
+    if (literal_parse(value, &number)) {
+        *out = (Node *) new (std::nothrow) NumNode(word_fit(number));
+        return true;
+    }
 
-    // must be a word operation
-    return (Node *) new (std::nothrow) NumNode(Value((const char *)value));
+    int i = op_find(value);
+    if (i >= 0) {
+        if (opTable[i] == NULL) {
+            EPRINT("operation: '%s' not implemented\n", opNames[i]);
+            rpn_exit(1);
+        }
+        *out = (Node *) new (std::nothrow) SymNode(opTable[i]);
+        return true;
+    }
+    return false;
 }
 
 static void node_free(Node *self) noexcept {
@@ -853,17 +1322,47 @@ SymNode::SymNode(SymOp op) noexcept :
 {
 }
 
+Node *SymNode::clone() noexcept {
+    return (Node *) new (std::nothrow) SymNode(*this);
+}
+
+void SymNode::save(ImageWriter& image) noexcept {
+    ImageInsn insn = {};
+    insn.kind = IMAGE_OP;
+    insn.arg = image.op(this->op);
+    image.insns.push_back(insn);
+}
+
 void SymNode::exec(std::stack<Value>& stack) noexcept {
     if (stack.size() < 1) {
         EPRINT("exec: stack empty\n");
-        exit(1);
+        rpn_exit(1);
+    }
+
+    if (op_isstackop(this->op)) {
+        ((SymStackop)this->op)(stack);
+        return;
     }
 
-    if (op_isunary(this->op)) {
+    unsigned arity = op_arity(this->op);
+    if (arity > 2) {
+        if (stack.size() < arity) {
+            EPRINT("%u operand op: Invalid stack\n", arity);
+            rpn_exit(1);
+        }
+
+        Value args[NARY_MAX];
+        for (unsigned i = arity; i-- > 0;) {
+            args[i] = maybe_a_constant(stack.top());
+            stack.pop();
+        }
+        stack.push(word_fit(((SymNaryop)this->op)(args)));
+    }
+    else if (arity == 1) {
         size_t size = stack.size();
         if (size < 1) {
             EPRINT("unary op: Invalid stack\n");
-            exit(1);
+            rpn_exit(1);
         }
 
         Value lhs = stack.top();
@@ -873,18 +1372,21 @@ void SymNode::exec(std::stack<Value>& stack) noexcept {
         SymUnop op = (SymUnop)this->op;
         Value res = op(lhs);
         if (op != unop_end && op != unop_sep && op != unop_quiet) {
-            stack.push(res);
+            stack.push(word_fit(res));
         }
     }
     else {
         size_t size = stack.size();
         if (size < 2) {
             EPRINT("binary op: Invalid stack\n");
-            exit(1);
+            rpn_exit(1);
         }
 
+        // the name of a save stays a name, even when already saved
         Value rhs = stack.top();
-        rhs = maybe_a_constant(rhs);
+        if (this->op != (SymOp)binop_save) {
+            rhs = maybe_a_constant(rhs);
+        }
         stack.pop();
 
         Value lhs = stack.top();
@@ -893,7 +1395,7 @@ void SymNode::exec(std::stack<Value>& stack) noexcept {
 
         SymBinop op = (SymBinop)this->op;
         Value res = op(lhs, rhs);
-        stack.push(res);
+        stack.push(word_fit(res));
     }
 }
 
@@ -902,6 +1404,35 @@ NumNode::NumNode(Value value) noexcept :
 {
 }
 
+Node *NumNode::clone() noexcept {
+    return (Node *) new (std::nothrow) NumNode(*this);
+}
+
+void NumNode::save(ImageWriter& image) noexcept {
+    ImageInsn insn = {};
+    insn.kind = IMAGE_VALUE;
+    insn.type = (uint8_t)this->value.type;
+    insn.fmt = (uint8_t)this->value.fmt;
+    if (this->value.type == TYPE_STRING) {
+        insn.arg = image.word(this->value.number.s);
+    }
+    else if (this->value.type == TYPE_BIG) {
+        EPRINT("compile: %s: bigint literals can't be compiled\n", big_to_string(this->value.number.b, 10).c_str());
+        rpn_exit(1);
+    }
+#if defined(RPN_128BITS)
+    else {
+        insn.kind = IMAGE_WIDE;
+        insn.arg = image.word(quad_text(this->value.number.u, 16, 0).text);
+    }
+#else
+    else {
+        memcpy(&insn.imm, &this->value.number, sizeof(Uint));
+    }
+#endif
+    image.insns.push_back(insn);
+}
+
 void NumNode::exec(std::stack<Value>& stack) noexcept {
     stack.push(this->value);
 }
@@ -914,61 +1445,206 @@ static Value binop_none(Value& lhs, Value& rhs) noexcept {
 }
 #endif
 
-static Value binop_add(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)(lhs.number.f + rhs.number.f));
-    case TYPE_INT:   return Value((Int)(lhs.number.i + rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)(lhs.number.u + rhs.number.u));
+// an integer or big as a big, for results past the word size with --bigint
+static const Big *big_of(Value& v) noexcept {
+    switch (v.type) {
+#if defined(RPN_128BITS)
+    case TYPE_INT:  return big_from_int128(v.number.i);
+    case TYPE_UINT: return big_from_uint128(v.number.u);
+#else
+    case TYPE_INT:  return big_from_int((int64_t)v.number.i);
+    case TYPE_UINT: return big_from_uint((uint64_t)v.number.u);
+#endif
     default: break;
     }
-    return lhs.unexpected_type();
+    assert(v.type == TYPE_BIG);
+    return v.number.b;
 }
 
-static Value binop_sub(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)(lhs.number.f - rhs.number.f));
-    case TYPE_INT:   return Value((Int)(lhs.number.i - rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)(lhs.number.u - rhs.number.u));
-    default: break;
-    }
-    return lhs.unexpected_type();
+// the low word of a big, two's complement
+static Uint big_word(const Big *b) noexcept {
+#if defined(RPN_128BITS)
+    return big_low128(b);
+#else
+    return (Uint)big_low(b);
+#endif
 }
 
-static Value binop_mul(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)(lhs.number.f * rhs.number.f));
-    case TYPE_INT:   return Value((Int)(lhs.number.i * rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)(lhs.number.u * rhs.number.u));
-    default: break;
+// a count of big results, those past 64 bits are all as large as they get
+static uint64_t big_count(Uint n) noexcept {
+#if defined(RPN_128BITS)
+    return n > UINT64_MAX ? UINT64_MAX : (uint64_t)n;
+#else
+    return (uint64_t)n;
+#endif
+}
+
+// big results of a count, refused when too large to be worth making
+static Value big_value(const char *op, const Big *big) noexcept {
+    if (!big) {
+        EPRINT("%s: result too large\n", op);
+        rpn_exit(1);
     }
-    return lhs.unexpected_type();
+    return Value(big);
 }
 
-static void int_divbyzero(Int a, Int b) noexcept {
-    EPRINT("Integer divide by zero: " FMT_INT " / " FMT_INT "\n",
-        a, b);
-    exit(ERANGE);
+// the bits of a word as a signed number, an int of 'hd --bits' sign extended
+static Int word_signed(Uint bits) noexcept {
+    return word_fit(Value((Int)bits)).number.i;
 }
 
-static void uint_divbyzero(Uint a, Uint b) noexcept {
-    EPRINT("Uinteger divide by zero: " FMT_UINT " / " FMT_UINT "\n",
-        a, b);
-    exit(ERANGE);
+// whether a result is past the word, wrapped past Int or Uint or past the
+// bits of 'hd --bits'
+static bool int_overflows(bool wrapped, Int result) noexcept {
+    return wrapped || word_signed((Uint)result) != result;
 }
 
-static Value binop_div(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
+static bool uint_overflows(bool wrapped, Uint result) noexcept {
+    return wrapped || (result & ~(Uint)MY_UINTMAX) != 0;
+}
+
+// -v of an int, past the word for its least value only
+static Value int_negate(const char *op, Value& v) noexcept {
+    Int neg;
+    bool wrapped = __builtin_sub_overflow((Int)0, v.number.i, &neg);
+    if (_bigint && int_overflows(wrapped, neg)) {
+        return Value(big_neg(big_of(v)));
+    }
+    if (_checked && int_overflows(wrapped, neg)) {
+        int_overflow(op, TYPE_INT);
+    }
+    return Value(neg);
+}
+
+static Value binop_add(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)(lhs.number.f + rhs.number.f));
+    case TYPE_INT: {
+        Int sum;
+        bool wrapped = __builtin_add_overflow(lhs.number.i, rhs.number.i, &sum);
+        if (_bigint && int_overflows(wrapped, sum)) {
+            return Value(big_add(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && int_overflows(wrapped, sum)) {
+            int_overflow(REG_OP_ADD, TYPE_INT);
+        }
+        return Value(sum);
+    }
+    case TYPE_UINT: {
+        Uint sum;
+        bool wrapped = __builtin_add_overflow(lhs.number.u, rhs.number.u, &sum);
+        if (_bigint && uint_overflows(wrapped, sum)) {
+            return Value(big_add(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && uint_overflows(wrapped, sum)) {
+            int_overflow(REG_OP_ADD, TYPE_UINT);
+        }
+        return Value(sum);
+    }
+    case TYPE_BIG: return Value(big_add(lhs.number.b, rhs.number.b));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value binop_sub(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)(lhs.number.f - rhs.number.f));
+    case TYPE_INT: {
+        Int diff;
+        bool wrapped = __builtin_sub_overflow(lhs.number.i, rhs.number.i, &diff);
+        if (_bigint && int_overflows(wrapped, diff)) {
+            return Value(big_sub(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && int_overflows(wrapped, diff)) {
+            int_overflow(REG_OP_SUB, TYPE_INT);
+        }
+        return Value(diff);
+    }
+    case TYPE_UINT: {
+        Uint diff;
+        bool wrapped = __builtin_sub_overflow(lhs.number.u, rhs.number.u, &diff);
+        if (_bigint && uint_overflows(wrapped, diff)) {
+            return Value(big_sub(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && uint_overflows(wrapped, diff)) {
+            int_overflow(REG_OP_SUB, TYPE_UINT);
+        }
+        return Value(diff);
+    }
+    case TYPE_BIG: return Value(big_sub(lhs.number.b, rhs.number.b));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value binop_mul(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)(lhs.number.f * rhs.number.f));
+    case TYPE_INT: {
+        Int product;
+        bool wrapped = __builtin_mul_overflow(lhs.number.i, rhs.number.i, &product);
+        if (_bigint && int_overflows(wrapped, product)) {
+            return Value(big_mul(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && int_overflows(wrapped, product)) {
+            int_overflow(REG_OP_MUL, TYPE_INT);
+        }
+        return Value(product);
+    }
+    case TYPE_UINT: {
+        Uint product;
+        bool wrapped = __builtin_mul_overflow(lhs.number.u, rhs.number.u, &product);
+        if (_bigint && uint_overflows(wrapped, product)) {
+            return Value(big_mul(big_of(lhs), big_of(rhs)));
+        }
+        if (_checked && uint_overflows(wrapped, product)) {
+            int_overflow(REG_OP_MUL, TYPE_UINT);
+        }
+        return Value(product);
+    }
+    case TYPE_BIG: return Value(big_mul(lhs.number.b, rhs.number.b));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static void int_divbyzero(Int a, Int b) noexcept {
+    EPRINT("Integer divide by zero: " FMT_INT " / " FMT_INT "\n",
+        INT_ARG(a), INT_ARG(b));
+    rpn_exit(ERANGE);
+}
+
+static void uint_divbyzero(Uint a, Uint b) noexcept {
+    EPRINT("Uinteger divide by zero: " FMT_UINT " / " FMT_UINT "\n",
+        UINT_ARG(a), UINT_ARG(b));
+    rpn_exit(ERANGE);
+}
+
+static const Big *big_divbyzero(const Big *a) noexcept {
+    EPRINT("Bigint divide by zero: %s / 0\n", big_to_string(a, 10).c_str());
+    rpn_exit(ERANGE);
+}
+
+static Value binop_div(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f / rhs.number.f));
     case TYPE_INT:
         if (rhs.number.i == 0) int_divbyzero(lhs.number.i, rhs.number.i);
+        // negated by hand, the divide instruction traps on the least Int / -1
+        if (rhs.number.i == -1) return int_negate(REG_OP_DIV, lhs);
         return Value((Int)(lhs.number.i / rhs.number.i));
     case TYPE_UINT:
         if (rhs.number.u == 0) uint_divbyzero(lhs.number.u, rhs.number.u);
         return Value((Uint)(lhs.number.u / rhs.number.u));
+    case TYPE_BIG: {
+        const Big *quot = big_div(lhs.number.b, rhs.number.b);
+        return Value(quot ? quot : big_divbyzero(lhs.number.b));
+    }
     default: break;
     }
     return lhs.unexpected_type();
@@ -980,21 +1656,63 @@ static Value binop_mod(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)FLOAT_MOD(lhs.number.f, rhs.number.f));
     case TYPE_INT:
         if (rhs.number.i == 0) int_divbyzero(lhs.number.i, rhs.number.i);
+        if (rhs.number.i == -1) return Value((Int)0); // as for div
         return Value((Int)(lhs.number.i % rhs.number.i));
     case TYPE_UINT:
         if (rhs.number.u == 0) uint_divbyzero(lhs.number.u, rhs.number.u);
         return Value((Uint)(lhs.number.u % rhs.number.u));
+    case TYPE_BIG: {
+        const Big *rem = big_mod(lhs.number.b, rhs.number.b);
+        return Value(rem ? rem : big_divbyzero(lhs.number.b));
+    }
     default: break;
     }
     return lhs.unexpected_type();
 }
 
+// whether base^exp is past max, base^exp of a base of 2 or more passes any
+// word within 64 steps
+static bool pow_overflows(Uint base, Uint exp, Uint max) noexcept {
+    Uint result = 1;
+    for (; base > 1 && exp > 0; exp--) {
+        if (__builtin_mul_overflow(result, base, &result) || result > max) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static Value binop_pow(Value& lhs, Value& rhs) noexcept {
     lhs.coerce(rhs);
     switch (lhs.type) {
     case TYPE_FLOAT: return Value((Float)FLOAT_POW(lhs.number.f, rhs.number.f));
-    case TYPE_INT:   return Value((Int)int_pow((unsigned long)lhs.number.i, (unsigned long)rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)int_pow((unsigned long)lhs.number.u, (unsigned long)rhs.number.u));
+    case TYPE_INT: {
+        Uint base = lhs.number.i < 0 ? (Uint)0 - (Uint)lhs.number.i : (Uint)lhs.number.i;
+        if (_bigint && rhs.number.i >= 0 && pow_overflows(base, (Uint)rhs.number.i, MY_INTMAX)) {
+            return big_value(REG_OP_POW, big_pow(big_of(lhs), big_count((Uint)rhs.number.i)));
+        }
+        // a negative result can reach one further, -2^(N-1)
+        Uint limit = (Uint)MY_INTMAX + (lhs.number.i < 0 && (rhs.number.i & 1));
+        if (_checked && rhs.number.i >= 0 && pow_overflows(base, (Uint)rhs.number.i, limit)) {
+            int_overflow(REG_OP_POW, TYPE_INT);
+        }
+        return Value((Int)WORD_POW(lhs.number.i, rhs.number.i));
+    }
+    case TYPE_UINT:
+        if (_bigint && pow_overflows(lhs.number.u, rhs.number.u, MY_UINTMAX)) {
+            return big_value(REG_OP_POW, big_pow(big_of(lhs), big_count(rhs.number.u)));
+        }
+        if (_checked && pow_overflows(lhs.number.u, rhs.number.u, MY_UINTMAX)) {
+            int_overflow(REG_OP_POW, TYPE_UINT);
+        }
+        return Value((Uint)WORD_POW(lhs.number.u, rhs.number.u));
+    case TYPE_BIG: {
+        const Big *exp = rhs.number.b;
+        if (exp->neg) {
+            return rhs.unexpected_type();
+        }
+        return big_value(REG_OP_POW, big_pow(lhs.number.b, exp->mag.size() > 1 ? UINT64_MAX : big_low(exp)));
+    }
     default: break;
     }
     return lhs.unexpected_type();
@@ -1103,16 +1821,49 @@ static Value binop_xor(Value& lhs, Value& rhs) noexcept {
     return lhs.unexpected_type();
 }
 
+// shifts by the width or more push every bit out, an arithmetic one leaves
+// copies of the sign, negative counts are as large as they get
+static Uint shift_left(Uint a, Uint n) noexcept {
+    return n >= WORD_BITS ? 0 : (Uint)(a << n);
+}
+
+static Uint shift_right(Uint a, Uint n) noexcept {
+    return n >= WORD_BITS ? 0 : (Uint)(a >> n);
+}
+
+static Int shift_right_arith(Int a, Uint n) noexcept {
+    return (Int)(a >> (n >= WORD_BITS ? WORD_BITS - 1 : n));
+}
+
+// whether shifting a word left by n drops set bits, or for a signed one
+// changes its value
+static bool shl_overflows(Uint a, Uint n, bool is_signed) noexcept {
+    a = WORD_MASK(a);
+    if (is_signed) {
+        Int v = word_signed(a);
+        return n >= WORD_BITS ? v != 0 : shift_right_arith(word_signed(shift_left(a, n)), n) != v;
+    }
+    return n >= WORD_BITS ? a != 0 : shift_right(a, WORD_BITS - n) != 0;
+}
+
 static Value binop_shl(Value& lhs, Value& rhs) noexcept {
     lhs.coerce(rhs);
     switch (lhs.type) {
     case TYPE_FLOAT: {
-        Value tmp = Value((Uint)(lhs.number.u << (Uint)round(rhs.number.f)));
+        Value tmp = Value(shift_left(lhs.number.u, (Uint)FLOAT_ROUND(rhs.number.f)));
         tmp.pun(TYPE_FLOAT);
         return tmp;
     }
-    case TYPE_INT:   return Value((Int)(lhs.number.i << rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)(lhs.number.u << rhs.number.u));
+    case TYPE_INT:
+        if (_checked && shl_overflows(lhs.number.u, (Uint)rhs.number.i, true)) {
+            int_overflow(REG_OP_SHL, TYPE_INT);
+        }
+        return Value((Int)shift_left(lhs.number.u, (Uint)rhs.number.i));
+    case TYPE_UINT:
+        if (_checked && shl_overflows(lhs.number.u, rhs.number.u, false)) {
+            int_overflow(REG_OP_SHL, TYPE_UINT);
+        }
+        return Value(shift_left(lhs.number.u, rhs.number.u));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1122,12 +1873,12 @@ static Value binop_shr(Value& lhs, Value& rhs) noexcept {
     lhs.coerce(rhs);
     switch (lhs.type) {
     case TYPE_FLOAT: {
-        Value tmp = Value((Uint)(lhs.number.u >> (Uint)round(rhs.number.f)));
+        Value tmp = Value(shift_right(lhs.number.u, (Uint)FLOAT_ROUND(rhs.number.f)));
         tmp.pun(TYPE_FLOAT);
         return tmp;
     }
-    case TYPE_INT:   return Value((Int)(lhs.number.i >> rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)(lhs.number.u >> rhs.number.u));
+    case TYPE_INT:   return Value(shift_right_arith(lhs.number.i, (Uint)rhs.number.i));
+    case TYPE_UINT:  return Value(shift_right(lhs.number.u, rhs.number.u));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1139,6 +1890,7 @@ static Value binop_equ(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f == rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i == rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u == rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) == 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1150,6 +1902,7 @@ static Value binop_neq(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f != rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i != rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u != rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) != 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1161,6 +1914,7 @@ static Value binop_gt(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f > rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i > rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u > rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) > 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1172,6 +1926,7 @@ static Value binop_gte(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f >= rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i >= rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u >= rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) >= 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1183,6 +1938,7 @@ static Value binop_lt(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f < rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i < rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u < rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) < 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1194,6 +1950,7 @@ static Value binop_lte(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)(lhs.number.f <= rhs.number.f));
     case TYPE_INT:   return Value((Int)(lhs.number.i <= rhs.number.i));
     case TYPE_UINT:  return Value((Uint)(lhs.number.u <= rhs.number.u));
+    case TYPE_BIG:   return Value((Int)(big_cmp(lhs.number.b, rhs.number.b) <= 0));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1222,6 +1979,11 @@ static Value binop_cast(Value& lhs, Value& rhs) noexcept {
                 tmp.coerce_exec((Type)i);
                 return tmp;
             }
+            case TYPE_BIG: {
+                Value tmp = Value(lhs.number.b);
+                tmp.coerce_exec((Type)i);
+                return tmp;
+            }
             default:
                 return lhs.unexpected_type();
             }
@@ -1231,6 +1993,15 @@ static Value binop_cast(Value& lhs, Value& rhs) noexcept {
     return rhs.unexpected_type();
 }
 
+// the operations on the bytes of the word, which a --bits of a part byte
+// doesn't have
+static void whole_bytes(const char *op) noexcept {
+    if ((MY_BITMAX + 1) % 8 != 0) {
+        EPRINT("%s: a word of %d bits isn't whole bytes\n", op, MY_BITMAX + 1);
+        rpn_exit(1);
+    }
+}
+
 static Value binop_pun(Value& lhs, Value& rhs) noexcept {
     if (rhs.type != TYPE_STRING) {
         return rhs.unexpected_type();
@@ -1238,6 +2009,9 @@ static Value binop_pun(Value& lhs, Value& rhs) noexcept {
 
     for (size_t i = 0; i < TYPE_COUNT; i++) {
         if (strcasecmp(rhs.number.s, typeTable[i]) == 0) {
+            if (i == TYPE_BIG) {
+                return rhs.unexpected_type();
+            }
             switch (lhs.type) {
             case TYPE_FLOAT: {
                 Value tmp = Value(lhs.number.f);
@@ -1262,6 +2036,9 @@ static Value binop_pun(Value& lhs, Value& rhs) noexcept {
 
     for (size_t i = 0; i < FORMAT_COUNT; i++) {
         if (strcasecmp(rhs.number.s, formatTable[i]) == 0) {
+            if (i == FORMAT_BIG || i == FORMAT_LITTLE) {
+                whole_bytes(formatTable[i]);
+            }
             switch (lhs.type) {
             case TYPE_FLOAT: {
                 Value tmp = Value(lhs.number.f);
@@ -1278,6 +2055,11 @@ static Value binop_pun(Value& lhs, Value& rhs) noexcept {
                 tmp.format((Format)i);
                 return tmp;
             }
+            case TYPE_BIG: {
+                Value tmp = Value(lhs.number.b);
+                tmp.format((Format)i);
+                return tmp;
+            }
             default:
                 return lhs.unexpected_type();
             }
@@ -1297,151 +2079,687 @@ static Value unop_sqrt(Value& lhs) noexcept {
     return lhs.unexpected_type();
 }
 
-static Value binop_gcd(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)gcd((unsigned long)lhs.number.f, (unsigned long)rhs.number.f));
-    case TYPE_INT:   return Value((Int)gcd((unsigned long)lhs.number.i, (unsigned long)rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)gcd((unsigned long)lhs.number.u, (unsigned long)rhs.number.u));
-    default: break;
-    }
-    return lhs.unexpected_type();
+static Value binop_gcd(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)WORD_GCD(lhs.number.f, rhs.number.f));
+    case TYPE_INT:   return Value((Int)WORD_GCD(lhs.number.i, rhs.number.i));
+    case TYPE_UINT:  return Value((Uint)WORD_GCD(lhs.number.u, rhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value binop_lcm(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)WORD_LCM(lhs.number.f, rhs.number.f));
+    case TYPE_INT:   return Value((Int)WORD_LCM(lhs.number.i, rhs.number.i));
+    case TYPE_UINT:  return Value((Uint)WORD_LCM(lhs.number.u, rhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+// the modular and prime operators work on 64 bits, numbers of 128 bit words
+// past that are refused
+static void limit_64(const char *op, Value& v) noexcept {
+#if defined(RPN_128BITS)
+    bool fits = true;
+    switch (v.type) {
+    case TYPE_FLOAT: fits = fabsq(v.number.f) < (Float)18446744073709551616.0; break;
+    case TYPE_INT:   fits = v.number.i >= -(Int)UINT64_MAX && v.number.i <= (Int)UINT64_MAX; break;
+    case TYPE_UINT:  fits = v.number.u <= UINT64_MAX; break;
+    default: break;
+    }
+    if (!fits) {
+        EPRINT("%s: operand past 64 bits\n", op);
+        rpn_exit(1);
+    }
+#else
+    (void)op;
+    (void)v;
+#endif
+}
+
+// the integer part of a float operand without its sign, casts of one past
+// the integers of the word are undefined so it's refused
+#if defined(RPN_128BITS)
+static Uint float_magnitude(const char *op, Float f) noexcept {
+    const Float limit = (Float)((Uint)1 << 127);
+    f = FLOAT_TRUNC(f);
+    if (!(f > -limit && f < limit)) {
+        EPRINT("%s: float operand past 127 bits\n", op);
+        rpn_exit(1);
+    }
+    return f < (Float)0 ? (Uint)-f : (Uint)f;
+}
+#else
+static uint64_t float_magnitude(const char *op, Float f) noexcept {
+    double d = trunc((double)f);
+    if (!(d > -18446744073709551616.0 && d < 18446744073709551616.0)) {
+        EPRINT("%s: float operand past 64 bits\n", op);
+        rpn_exit(1);
+    }
+    return d < 0 ? (uint64_t)-d : (uint64_t)d;
+}
+#endif
+
+// a modulus, positive
+static uint64_t modulus_of(const char *op, Value& v) noexcept {
+    limit_64(op, v);
+    uint64_t m = 0;
+    switch (v.type) {
+    case TYPE_FLOAT: m = v.number.f >= 1 ? (uint64_t)float_magnitude(op, v.number.f) : 0; break;
+    case TYPE_INT:   m = v.number.i > 0 ? (uint64_t)v.number.i : 0; break;
+    case TYPE_UINT:  m = v.number.u; break;
+    default: v.unexpected_type();
+    }
+    if (m == 0) {
+        EPRINT("%s: modulus must be positive\n", op);
+        rpn_exit(1);
+    }
+    return m;
+}
+
+// v modulo m, negatives to their positive residue
+static uint64_t residue_of(const char *op, Value& v, uint64_t m) noexcept {
+    Int i;
+    uint64_t r;
+    switch (v.type) {
+    case TYPE_FLOAT:
+        r = (uint64_t)(float_magnitude(op, v.number.f) % m);
+        return v.number.f < (Float)0 && r ? m - r : r;
+    case TYPE_INT:   i = v.number.i; break;
+    case TYPE_UINT:  return (uint64_t)(v.number.u % m);
+    default: v.unexpected_type();
+    }
+    if (i >= 0) {
+        return (uint64_t)((Uint)i % m);
+    }
+    r = (uint64_t)((Uint)((Uint)0 - (Uint)i) % m);
+    return r ? m - r : 0;
+}
+
+// a residue as the type of the modulus, where it always fits
+static Value residue_as(uint64_t r, Value& like) noexcept {
+    switch (like.type) {
+    case TYPE_FLOAT: return Value((Float)r);
+    case TYPE_INT:   return Value((Int)r);
+    default: break;
+    }
+    return Value((Uint)r);
+}
+
+// a b m
+static Value naryop_addmod(Value *args) noexcept {
+    uint64_t m = modulus_of(REG_OP_ADDMOD, args[2]);
+    return residue_as(addmod(residue_of(REG_OP_ADDMOD, args[0], m), residue_of(REG_OP_ADDMOD, args[1], m), m), args[2]);
+}
+
+static Value naryop_mulmod(Value *args) noexcept {
+    uint64_t m = modulus_of(REG_OP_MULMOD, args[2]);
+    return residue_as(mulmod(residue_of(REG_OP_MULMOD, args[0], m), residue_of(REG_OP_MULMOD, args[1], m), m), args[2]);
+}
+
+static uint64_t inverse_of(const char *op, uint64_t a, uint64_t m) noexcept {
+    uint64_t inv;
+    if (!invmod(a, m, &inv)) {
+        EPRINT("%s: %llu has no inverse modulo %llu\n", op, (unsigned long long)a, (unsigned long long)m);
+        rpn_exit(1);
+    }
+    return inv;
+}
+
+// base^e mod m, an e of 128 bits as (base^(2^64))^hi * base^lo
+static uint64_t word_powmod(uint64_t base, Uint e, uint64_t m) noexcept {
+#if defined(RPN_128BITS)
+    uint64_t hi = (uint64_t)(e >> 64);
+    uint64_t r = powmod(base, (uint64_t)e, m);
+    if (hi) {
+        uint64_t high = powmod(powmod(base, (uint64_t)1 << 32, m), (uint64_t)1 << 32, m);
+        r = mulmod(r, powmod(high, hi, m), m);
+    }
+    return r;
+#else
+    return powmod(base, (uint64_t)e, m);
+#endif
+}
+
+// base exp m, a negative exp raises the inverse of base
+static Value naryop_powmod(Value *args) noexcept {
+    uint64_t m = modulus_of(REG_OP_POWMOD, args[2]);
+    uint64_t base = residue_of(REG_OP_POWMOD, args[0], m);
+    Uint e;
+    switch (args[1].type) {
+    case TYPE_FLOAT:
+        e = (Uint)float_magnitude(REG_OP_POWMOD, args[1].number.f);
+        e = args[1].number.f < (Float)0 ? (Uint)0 - e : e;
+        break;
+    case TYPE_INT:   e = (Uint)args[1].number.i; break;
+    case TYPE_UINT:  e = args[1].number.u; break;
+    default: return args[1].unexpected_type();
+    }
+    if (args[1].type != TYPE_UINT && (Int)e < 0) {
+        base = inverse_of(REG_OP_POWMOD, base, m);
+        e = (Uint)((Uint)0 - e);
+    }
+    return residue_as(word_powmod(base, e, m), args[2]);
+}
+
+// a m
+static Value binop_invmod(Value& lhs, Value& rhs) noexcept {
+    uint64_t m = modulus_of(REG_OP_INVMOD, rhs);
+    return residue_as(inverse_of(REG_OP_INVMOD, residue_of(REG_OP_INVMOD, lhs, m), m), rhs);
+}
+
+// rotates and funnel shifts go by the count modulo the width, the compilers
+// make a single instruction of these forms
+static Uint ror(Uint a, Uint b) noexcept {
+    Uint k = b % WORD_BITS;
+    a = WORD_MASK(a);
+    return (Uint)((a >> k) | (a << ((WORD_BITS - k) % WORD_BITS)));
+}
+
+static Uint rol(Uint a, Uint b) noexcept {
+    Uint k = b % WORD_BITS;
+    a = WORD_MASK(a);
+    return (Uint)((a << k) | (a >> ((WORD_BITS - k) % WORD_BITS)));
+}
+
+// the high word of hi:lo shifted left
+static Uint fshl(Uint hi, Uint lo, Uint b) noexcept {
+    Uint k = b % WORD_BITS;
+    return k ? (Uint)((hi << k) | (WORD_MASK(lo) >> (WORD_BITS - k))) : hi;
+}
+
+// the low word of hi:lo shifted right
+static Uint fshr(Uint hi, Uint lo, Uint b) noexcept {
+    Uint k = b % WORD_BITS;
+    return k ? (Uint)((WORD_MASK(lo) >> k) | (hi << (WORD_BITS - k))) : lo;
+}
+
+/**
+ * The bit kernels over the word, one of 128 bits is worked on as its two
+ * halves of 64
+ */
+
+#if defined(RPN_128BITS)
+#define WORD_LO(v) ((uint64_t)(v))
+#define WORD_HI(v) ((uint64_t)((v) >> 64))
+#define WORD_OF(hi, lo) ((Uint)(hi) << 64 | (Uint)(lo))
+
+static unsigned word_popcount(Uint value) noexcept {
+    return bit_kernels.popcount(WORD_LO(value)) + bit_kernels.popcount(WORD_HI(value));
+}
+
+// the low len bits, all of them for len past the word
+static Uint low_mask(Uint len) noexcept {
+    if (len <= 64) {
+        return bit_kernels.mask((unsigned)len);
+    }
+    return WORD_OF(bit_kernels.mask((unsigned)MYMIN(len - 64, (Uint)64)), UINT64_MAX);
+}
+
+static Uint word_extract(Uint value, Uint start, Uint len) noexcept {
+    return (value >> start) & low_mask(len);
+}
+
+// the high half of mask takes the bits of value past the popcount of its low
+static Uint word_deposit(Uint value, Uint mask) noexcept {
+    uint64_t lo = bit_kernels.deposit(WORD_LO(value), WORD_LO(mask));
+    uint64_t hi = bit_kernels.deposit(WORD_LO(value >> bit_kernels.popcount(WORD_LO(mask))), WORD_HI(mask));
+    return WORD_OF(hi, lo);
+}
+
+static Uint word_gather(Uint value, Uint mask) noexcept {
+    Uint lo = bit_kernels.gather(WORD_LO(value), WORD_LO(mask));
+    Uint hi = bit_kernels.gather(WORD_HI(value), WORD_HI(mask));
+    return lo | hi << bit_kernels.popcount(WORD_LO(mask));
+}
+
+// 64 bits to the even ones and back
+static Uint word_spread2(Uint value) noexcept {
+    return WORD_OF(bit_kernels.spread2(WORD_LO(value) >> 32), bit_kernels.spread2(WORD_LO(value)));
+}
+
+static Uint word_compact2(Uint code) noexcept {
+    return bit_kernels.compact2(WORD_LO(code)) | bit_kernels.compact2(WORD_HI(code)) << 32;
+}
+
+// 42 bits to every third and back, the halves split at bit 63
+static Uint word_spread3(Uint value) noexcept {
+    return bit_kernels.spread3(WORD_LO(value)) | (Uint)bit_kernels.spread3(WORD_LO(value >> 21)) << 63;
+}
+
+static Uint word_compact3(Uint code) noexcept {
+    return bit_kernels.compact3(WORD_LO(code)) | bit_kernels.compact3(WORD_LO(code >> 63)) << 21;
+}
+
+static Uint word_lanes(LaneOp op, Uint a, Uint b, unsigned lane, bool is_signed) noexcept {
+    return WORD_OF(lane_ops.op(op, WORD_HI(a), WORD_HI(b), lane, is_signed),
+        lane_ops.op(op, WORD_LO(a), WORD_LO(b), lane, is_signed));
+}
+
+// pshufb of 16 bytes, bit 3 of each selector picks the half: the bytes of
+// the other one are shuffled in as zeros by setting bit 7
+static Uint word_shuffle(Uint value, Uint sel) noexcept {
+    const uint64_t bit3 = 0x0808080808080808;
+    uint64_t out[2];
+    for (int i = 0; i < 2; i++) {
+        uint64_t s = i ? WORD_HI(sel) : WORD_LO(sel);
+        out[i] = lane_ops.shuffle(WORD_LO(value), s | (s & bit3) << 4) |
+            lane_ops.shuffle(WORD_HI(value), s | (~s & bit3) << 4);
+    }
+    return WORD_OF(out[1], out[0]);
+}
+#else
+static unsigned word_popcount(Uint value) noexcept {
+    return bit_kernels.popcount(value);
+}
+
+// the low len bits, all of them for len past the word
+static Uint low_mask(Uint len) noexcept {
+    return (Uint)bit_kernels.mask((unsigned)MYMIN(len, (Uint)64));
+}
+
+static Uint word_extract(Uint value, Uint start, Uint len) noexcept {
+    return (Uint)bit_kernels.extract(value, (unsigned)start, (unsigned)MYMIN(len, (Uint)64));
+}
+
+static Uint word_deposit(Uint value, Uint mask) noexcept {
+    return (Uint)bit_kernels.deposit(value, mask);
+}
+
+static Uint word_gather(Uint value, Uint mask) noexcept {
+    return (Uint)bit_kernels.gather(value, mask);
+}
+
+static Uint word_spread2(Uint value) noexcept {
+    return (Uint)bit_kernels.spread2(value);
+}
+
+static Uint word_compact2(Uint code) noexcept {
+    return (Uint)bit_kernels.compact2(code);
+}
+
+static Uint word_spread3(Uint value) noexcept {
+    return (Uint)bit_kernels.spread3(value);
+}
+
+static Uint word_compact3(Uint code) noexcept {
+    return (Uint)bit_kernels.compact3(code);
+}
+
+static Uint word_lanes(LaneOp op, Uint a, Uint b, unsigned lane, bool is_signed) noexcept {
+    return (Uint)lane_ops.op(op, a, b, lane, is_signed);
+}
+
+// pshufb of the 8 bytes of a 64 bit word, those past a narrower one read as 0
+static Uint word_shuffle(Uint value, Uint sel) noexcept {
+    return (Uint)lane_ops.shuffle(value, sel);
+}
+#endif
+
+// len bits from bit start on, those past the word read as 0
+static Uint bit_extract(Uint value, Uint start, Uint len) noexcept {
+    if (start >= WORD_BITS) {
+        return 0;
+    }
+    return word_extract(WORD_MASK(value), start, len);
+}
+
+// the low len bits of field put over those from bit start on, the ones
+// past the word are dropped
+static Uint bit_insert(Uint value, Uint field, Uint start, Uint len) noexcept {
+    if (start >= WORD_BITS) {
+        return value;
+    }
+    Uint mask = (Uint)(low_mask(len) << start);
+    return (Uint)((value & ~mask) | ((Uint)(field << start) & mask));
+}
+
+// the bits above bit made copies of it, a field whose sign it is widened to
+// the word
+static Uint sign_extend(Uint value, Uint bit) noexcept {
+    if (bit >= WORD_BITS - 1) {
+        return value;
+    }
+    Uint sign = (Uint)((Uint)1 << bit);
+    Uint field = value & (Uint)(sign | (sign - 1));
+    return (Uint)((field ^ sign) - sign);
+}
+
+static Value binop_ror(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: {
+        Value tmp = Value(ror((Uint)lhs.number.u, (Uint)rhs.number.f));
+        tmp.pun(TYPE_FLOAT);
+        return tmp;
+    }
+    case TYPE_INT:   return Value((Int)ror(lhs.number.u, (Uint)rhs.number.i));
+    case TYPE_UINT:  return Value((Uint)ror(lhs.number.u, rhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value binop_rol(Value& lhs, Value& rhs) noexcept {
+    lhs.coerce(rhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: {
+        Value tmp = Value(rol((Uint)lhs.number.u, (Uint)rhs.number.f));
+        tmp.pun(TYPE_FLOAT);
+        return tmp;
+    }
+    case TYPE_INT:   return Value((Int)rol(lhs.number.u, (Uint)rhs.number.i));
+    case TYPE_UINT:  return Value((Uint)rol(lhs.number.u, rhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+// a shift count or field position, whatever the operand's type
+static Uint count_of(Value& v) noexcept {
+    switch (v.type) {
+    case TYPE_FLOAT: return (Uint)(Int)FLOAT_ROUND(v.number.f);
+    case TYPE_INT:   return (Uint)v.number.i;
+    case TYPE_UINT:  return v.number.u;
+    default: break;
+    }
+    v.unexpected_type();
+    return 0;
+}
+
+// the word's bits as the type of like, floats by punning
+static Value bits_as(Uint bits, Value& like) noexcept {
+    switch (like.type) {
+    case TYPE_FLOAT: {
+        Value tmp = Value(bits);
+        tmp.pun(TYPE_FLOAT);
+        return tmp;
+    }
+    case TYPE_INT:  return Value((Int)bits);
+    case TYPE_UINT: return Value(bits);
+    default: break;
+    }
+    return like.unexpected_type();
+}
+
+// hi lo count
+static Value naryop_fshl(Value *args) noexcept {
+    args[0].coerce(args[1]);
+    return bits_as(fshl(args[0].number.u, args[1].number.u, count_of(args[2])), args[0]);
+}
+
+static Value naryop_fshr(Value *args) noexcept {
+    args[0].coerce(args[1]);
+    return bits_as(fshr(args[0].number.u, args[1].number.u, count_of(args[2])), args[0]);
+}
+
+// value start len
+static Value naryop_extract(Value *args) noexcept {
+    return bits_as(bit_extract(args[0].number.u, count_of(args[1]), count_of(args[2])), args[0]);
+}
+
+// value field start len
+static Value naryop_insert(Value *args) noexcept {
+    Uint field = args[1].type == TYPE_FLOAT ? args[1].number.u : count_of(args[1]);
+    return bits_as(bit_insert(args[0].number.u, field, count_of(args[2]), count_of(args[3])), args[0]);
+}
+
+// the word's bits of a number, floats unconverted
+static Uint bits_of(Value& v) noexcept {
+    switch (v.type) {
+    case TYPE_FLOAT:
+    case TYPE_INT:
+    case TYPE_UINT: return WORD_MASK(v.number.u);
+    default: break;
+    }
+    v.unexpected_type();
+    return 0;
+}
+
+// value bit, an int of the bits above bit made copies of it. bit is an
+// index from 0, the top bit of a field, not its width.
+static Value binop_sext(Value& lhs, Value& rhs) noexcept {
+    return Value((Int)sign_extend(bits_of(lhs), count_of(rhs)));
+}
+
+// value mask, the low bits of value put at the set bits of mask
+static Value binop_pdep(Value& lhs, Value& rhs) noexcept {
+    return bits_as(word_deposit(bits_of(lhs), bits_of(rhs)), lhs);
+}
+
+// value mask, the bits of value at the set bits of mask packed low
+static Value binop_pext(Value& lhs, Value& rhs) noexcept {
+    return bits_as(word_gather(bits_of(lhs), bits_of(rhs)), lhs);
+}
+
+/**
+ * Morton (Z-order) codes of the word, each coordinate gets a half or a third
+ * of it: x in bits 0, 2, 4... or 0, 3, 6... then y and z one and two above.
+ * Coordinate bits past their share are dropped.
+ */
+
+#define MORTON2_BITS (WORD_BITS / 2)
+#define MORTON3_BITS (WORD_BITS / 3)
+
+// x y
+static Value binop_interleave(Value& lhs, Value& rhs) noexcept {
+    Uint x = word_spread2(bits_of(lhs) & low_mask(MORTON2_BITS));
+    Uint y = word_spread2(bits_of(rhs) & low_mask(MORTON2_BITS));
+    return bits_as((Uint)(x | y << 1), lhs);
+}
+
+// x y z
+static Value naryop_interleave3(Value *args) noexcept {
+    Uint x = word_spread3(bits_of(args[0]) & low_mask(MORTON3_BITS));
+    Uint y = word_spread3(bits_of(args[1]) & low_mask(MORTON3_BITS));
+    Uint z = word_spread3(bits_of(args[2]) & low_mask(MORTON3_BITS));
+    return bits_as((Uint)(x | y << 1 | z << 2), args[0]);
 }
 
-static Value binop_lcm(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)lcm((unsigned long)lhs.number.f, (unsigned long)rhs.number.f));
-    case TYPE_INT:   return Value((Int)lcm((unsigned long)lhs.number.i, (unsigned long)rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)lcm((unsigned long)lhs.number.u, (unsigned long)rhs.number.u));
-    default: break;
+static Uint axis_of(const char *op, Value& v, Uint axes) noexcept {
+    Uint axis = count_of(v);
+    if (axis >= axes) {
+        EPRINT("%s: axis must be below %u\n", op, (unsigned)axes);
+        rpn_exit(1);
     }
-    return lhs.unexpected_type();
+    return axis;
 }
 
-static Uint ror1(Uint a) noexcept {
-    const Uint lsb = a & 0x1;
-    const Uint rest = a >> 1;
-    const Uint result = (lsb << MY_BITMAX) | rest;
-    return result;
+// code axis, the coordinate of axis 0 (x) or 1 (y)
+static Value binop_deinterleave(Value& lhs, Value& rhs) noexcept {
+    Uint axis = axis_of(REG_OP_DEINTERLEAVE, rhs, 2);
+    return bits_as(word_compact2((Uint)(bits_of(lhs) >> axis)), lhs);
 }
 
-static Uint ror(Uint a, Uint b) noexcept {
-    for (Uint copy = 0; copy < b; copy++) {
-        a = ror1(a);
+// code axis, the coordinate of axis 0 (x), 1 (y) or 2 (z)
+static Value binop_deinterleave3(Value& lhs, Value& rhs) noexcept {
+    Uint axis = axis_of(REG_OP_DEINTERLEAVE3, rhs, 3);
+    Uint code = bits_of(lhs) & low_mask(3 * MORTON3_BITS);
+    return bits_as(word_compact3((Uint)(code >> axis)), lhs);
+}
+
+#undef MORTON2_BITS
+#undef MORTON3_BITS
+
+/**
+ * Lane operators, the word as the packed lanes of a vector register: paddb,
+ * paddsw, pminud, pcmpeqb and so on. Ints have signed lanes, uints and the
+ * bits of floats unsigned ones, the word's type is the first operand's.
+ */
+
+static Value lane_binop(const char *op, LaneOp which, unsigned lane, Value& lhs, Value& rhs) noexcept {
+    if (lane > WORD_BITS) {
+        EPRINT("%s: lanes of %u bits are wider than the word\n", op, lane);
+        rpn_exit(1);
     }
-    return a;
+    return bits_as(word_lanes(which, bits_of(lhs), bits_of(rhs), lane, lhs.type == TYPE_INT), lhs);
 }
 
-static Uint rol1(Uint a) noexcept {
-    const Uint msb = a >> MY_BITMAX;
-    const Uint rest = a << 1;
-    const Uint result = rest | msb;
-    return result;
+#define LANE_BINOP(Func, Name, Op, Lane) \
+static Value Func(Value& lhs, Value& rhs) noexcept { \
+    return lane_binop(Name, Op, Lane, lhs, rhs); \
 }
 
-static Uint rol(Uint a, Uint b) noexcept {
-    for (Uint copy = 0; copy < b; copy++) {
-        a = rol1(a);
-    }
-    return a;
+LANE_BINOP(binop_ladd8, REG_OP_LADD8, LANE_ADD, 8)
+LANE_BINOP(binop_ladd16, REG_OP_LADD16, LANE_ADD, 16)
+LANE_BINOP(binop_ladd32, REG_OP_LADD32, LANE_ADD, 32)
+LANE_BINOP(binop_lsub8, REG_OP_LSUB8, LANE_SUB, 8)
+LANE_BINOP(binop_lsub16, REG_OP_LSUB16, LANE_SUB, 16)
+LANE_BINOP(binop_lsub32, REG_OP_LSUB32, LANE_SUB, 32)
+LANE_BINOP(binop_lsat_add8, REG_OP_LSAT_ADD8, LANE_SAT_ADD, 8)
+LANE_BINOP(binop_lsat_add16, REG_OP_LSAT_ADD16, LANE_SAT_ADD, 16)
+LANE_BINOP(binop_lsat_add32, REG_OP_LSAT_ADD32, LANE_SAT_ADD, 32)
+LANE_BINOP(binop_lsat_sub8, REG_OP_LSAT_SUB8, LANE_SAT_SUB, 8)
+LANE_BINOP(binop_lsat_sub16, REG_OP_LSAT_SUB16, LANE_SAT_SUB, 16)
+LANE_BINOP(binop_lsat_sub32, REG_OP_LSAT_SUB32, LANE_SAT_SUB, 32)
+LANE_BINOP(binop_lmin8, REG_OP_LMIN8, LANE_MIN, 8)
+LANE_BINOP(binop_lmin16, REG_OP_LMIN16, LANE_MIN, 16)
+LANE_BINOP(binop_lmin32, REG_OP_LMIN32, LANE_MIN, 32)
+LANE_BINOP(binop_lmax8, REG_OP_LMAX8, LANE_MAX, 8)
+LANE_BINOP(binop_lmax16, REG_OP_LMAX16, LANE_MAX, 16)
+LANE_BINOP(binop_lmax32, REG_OP_LMAX32, LANE_MAX, 32)
+LANE_BINOP(binop_lcmpeq8, REG_OP_LCMPEQ8, LANE_CMPEQ, 8)
+LANE_BINOP(binop_lcmpeq16, REG_OP_LCMPEQ16, LANE_CMPEQ, 16)
+LANE_BINOP(binop_lcmpeq32, REG_OP_LCMPEQ32, LANE_CMPEQ, 32)
+LANE_BINOP(binop_lcmpgt8, REG_OP_LCMPGT8, LANE_CMPGT, 8)
+LANE_BINOP(binop_lcmpgt16, REG_OP_LCMPGT16, LANE_CMPGT, 16)
+LANE_BINOP(binop_lcmpgt32, REG_OP_LCMPGT32, LANE_CMPGT, 32)
+#undef LANE_BINOP
+
+// value selectors, the byte of value at the low bits of each byte of the
+// selectors, 0 for those with the top bit set
+static Value binop_lshuf8(Value& lhs, Value& rhs) noexcept {
+    whole_bytes(REG_OP_LSHUF8);
+    return bits_as(word_shuffle(bits_of(lhs), bits_of(rhs)), lhs);
+}
+
+// n! wrapping past the largest that fits a Uint, only used up to that
+static constexpr Uint fact_of(unsigned n) noexcept {
+    return n < 2 ? 1 : (Uint)(n * fact_of(n - 1));
+}
+
+// largest n with n! no more than max
+static constexpr unsigned fact_limit(Uint max, unsigned n = 1, Uint f = 1) noexcept {
+    return f > max / (n + 1) ? n : fact_limit(max, n + 1, (Uint)(f * (n + 1)));
+}
+
+// up to 34!, the largest that fits 128 bits
+static constexpr Uint factorials[] = {
+    fact_of(0), fact_of(1), fact_of(2), fact_of(3), fact_of(4),
+    fact_of(5), fact_of(6), fact_of(7), fact_of(8), fact_of(9),
+    fact_of(10), fact_of(11), fact_of(12), fact_of(13), fact_of(14),
+    fact_of(15), fact_of(16), fact_of(17), fact_of(18), fact_of(19),
+    fact_of(20), fact_of(21), fact_of(22), fact_of(23), fact_of(24),
+    fact_of(25), fact_of(26), fact_of(27), fact_of(28), fact_of(29),
+    fact_of(30), fact_of(31), fact_of(32), fact_of(33), fact_of(34),
+};
+static_assert(fact_limit((Uint)~(Uint)0) < sizeof(factorials) / sizeof(factorials[0]), "factorial table");
+
+[[noreturn]] static void int_overflow(const char *op, Type type) noexcept {
+    EPRINT("%s: result overflows %s\n", op, typeTable[type]);
+    rpn_exit(1);
 }
 
-static Value binop_ror(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: {
-        Value tmp = Value(ror((Uint)lhs.number.u, (Uint)rhs.number.f));
-        tmp.pun(TYPE_FLOAT);
-        return tmp;
-    }
-    case TYPE_INT:   return Value((Int)ror(lhs.number.u, (Uint)rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)ror(lhs.number.u, rhs.number.u));
-    default: break;
-    }
-    return lhs.unexpected_type();
+static Value int_value(Uint result, Type type) noexcept {
+    return type == TYPE_INT ? Value((Int)result) : Value(result);
 }
 
-static Value binop_rol(Value& lhs, Value& rhs) noexcept {
-    lhs.coerce(rhs);
-    switch (lhs.type) {
-    case TYPE_FLOAT: {
-        Value tmp = Value(rol((Uint)lhs.number.u, (Uint)rhs.number.f));
-        tmp.pun(TYPE_FLOAT);
-        return tmp;
-    }
-    case TYPE_INT:   return Value((Int)rol(lhs.number.u, (Uint)rhs.number.i));
-    case TYPE_UINT:  return Value((Uint)rol(lhs.number.u, rhs.number.u));
-    default: break;
+static Value int_factorial(Uint n, Uint max, Type type) noexcept {
+    if (n > fact_limit(max)) {
+        if (_bigint) {
+            return big_value(REG_OP_FACTORIAL, big_factorial(big_count(n)));
+        }
+        int_overflow(REG_OP_FACTORIAL, type);
+    }
+    return int_value(factorials[n], type);
+}
+
+// C(n, r) = C(n - r + i - 1, i - 1) * (n - r + i) / i with the gcd taken out
+// of the division first, so each step is exact and only grows
+static Value int_ncr(Uint n, Uint r, Uint max, Type type) noexcept {
+    Uint least = r > n - r ? n - r : r;
+    Uint result = 1;
+    for (Uint i = 1; i <= least; i++) {
+        Uint g = (Uint)WORD_GCD(result, i);
+        Uint k = (Uint)((n - least + i) / (i / g));
+        if (__builtin_mul_overflow((Uint)(result / g), k, &result) || result > max) {
+            if (_bigint) {
+                return big_value(REG_OP_NCR, big_ncr(big_count(n), big_count(r)));
+            }
+            int_overflow(REG_OP_NCR, type);
+        }
     }
-    return lhs.unexpected_type();
+    return int_value(result, type);
 }
 
-#define FACTORIAL_CHK(out, value, check) \
-do { \
-    if (check) { \
-        EPRINT("factorial: value must be nonnegative\n"); \
-        exit(1); \
-    } \
-    decltype(out) my__tmp = 1; \
-    for (size_t i = 2; i <= (size_t)(value); i++) { \
-        my__tmp *= i; \
-    } \
-    out = my__tmp; \
-} while (0)
-
-#define FACTORIAL(out, value) FACTORIAL_CHK(out, value, (value < 0))
-#define FACTORIAL_NO(out, value) FACTORIAL_CHK(out, value, false)
+// n (n - 1) ... (n - r + 1)
+static Value int_npr(Uint n, Uint r, Uint max, Type type) noexcept {
+    Uint result = 1;
+    for (Uint i = 0; i < r; i++) {
+        if (__builtin_mul_overflow(result, (Uint)(n - i), &result) || result > max) {
+            if (_bigint) {
+                return big_value(REG_OP_NPR, big_npr(big_count(n), big_count(r)));
+            }
+            int_overflow(REG_OP_NPR, type);
+        }
+    }
+    return int_value(result, type);
+}
 
-#define NCR_CHK(out, n, r, check, FACT) \
-do { \
-    if (check) { \
-        EPRINT("ncr: requires n >= r >= 0\n"); \
-        exit(1); \
-    } \
-    decltype(out) f__n, f__r, f__nr; \
-    FACT(f__n, n); \
-    FACT(f__r, r); \
-    FACT(f__nr, n - r); \
-    out = f__n / (f__r * f__nr); \
-} while (0)
+// floats are taken as their integer part and overflow to inf
+static Float float_factorial(Float n) noexcept {
+    return (Float)tgamma(trunc((double)n) + 1);
+}
 
-#define NCR(out, n, r) NCR_CHK(out, n, r, (r < 0) || (n < r), FACTORIAL)
-#define NCR_NO(out, n, r) NCR_CHK(out, n, r, (n < r), FACTORIAL_NO)
+static Float float_ncr(Float n, Float r) noexcept {
+    double dn = trunc((double)n);
+    double dr = trunc((double)r);
+    if (dr > dn - dr) {
+        dr = dn - dr;
+    }
+    double result = 1;
+    for (double i = 1; i <= dr && !isinf(result); i++) {
+        result = result * (dn - dr + i) / i;
+    }
+    return (Float)result;
+}
 
-#define NPR_CHK(out, n, r, check, FACT) \
-do { \
-    if (check) { \
-        EPRINT("npr: requires n >= r >= 0\n"); \
-        exit(1); \
-    } \
-    decltype(out) f__n, f__nr; \
-    FACT(f__n, n); \
-    FACT(f__nr, n - r); \
-    out = f__n / f__nr; \
-} while (0)
+static Float float_npr(Float n, Float r) noexcept {
+    double dn = trunc((double)n);
+    double dr = trunc((double)r);
+    double result = 1;
+    for (double i = 0; i < dr && !isinf(result); i++) {
+        result *= dn - i;
+    }
+    return (Float)result;
+}
 
-#define NPR(out, n, r) NPR_CHK(out, n, r, (r < 0) || (n < r), FACTORIAL)
-#define NPR_NO(out, n, r) NPR_CHK(out, n, r, (n < r), FACTORIAL_NO)
+static void ncr_check(const char *op, Value& n, Value& r) noexcept {
+    bool valid;
+    switch (n.type) {
+    case TYPE_FLOAT: valid = r.number.f >= 0 && n.number.f >= r.number.f; break;
+    case TYPE_INT:   valid = r.number.i >= 0 && n.number.i >= r.number.i; break;
+    case TYPE_UINT:  valid = n.number.u >= r.number.u; break;
+    default: return;
+    }
+    if (!valid) {
+        EPRINT("%s: requires n >= r >= 0\n", op);
+        rpn_exit(1);
+    }
+}
 
 static Value binop_ncr(Value& lhs, Value& rhs) noexcept {
     lhs.coerce(rhs);
+    ncr_check(REG_OP_NCR, lhs, rhs);
     switch (lhs.type) {
-    case TYPE_FLOAT: {
-        Float result;
-        NCR(result, lhs.number.f, rhs.number.f);
-        return Value(result);
-    }
-    case TYPE_INT: {
-        Int result;
-        NCR(result, lhs.number.i, rhs.number.i);
-        return Value(result);
-    }
-    case TYPE_UINT: {
-        Uint result;
-        NCR_NO(result, lhs.number.u, rhs.number.u);
-        return Value(result);
-    }
+    case TYPE_FLOAT: return Value((Float)float_ncr(lhs.number.f, rhs.number.f));
+    case TYPE_INT:   return int_ncr((Uint)lhs.number.i, (Uint)rhs.number.i, MY_INTMAX, TYPE_INT);
+    case TYPE_UINT:  return int_ncr(lhs.number.u, rhs.number.u, MY_UINTMAX, TYPE_UINT);
     default: break;
     }
     return lhs.unexpected_type();
@@ -1449,22 +2767,11 @@ static Value binop_ncr(Value& lhs, Value& rhs) noexcept {
 
 static Value binop_npr(Value& lhs, Value& rhs) noexcept {
     lhs.coerce(rhs);
+    ncr_check(REG_OP_NPR, lhs, rhs);
     switch (lhs.type) {
-    case TYPE_FLOAT: {
-        Float result;
-        NPR(result, lhs.number.f, rhs.number.f);
-        return Value(result);
-    }
-    case TYPE_INT: {
-        Int result;
-        NPR(result, lhs.number.i, rhs.number.i);
-        return Value(result);
-    }
-    case TYPE_UINT: {
-        Uint result;
-        NPR_NO(result, lhs.number.u, rhs.number.u);
-        return Value(result);
-    }
+    case TYPE_FLOAT: return Value((Float)float_npr(lhs.number.f, rhs.number.f));
+    case TYPE_INT:   return int_npr((Uint)lhs.number.i, (Uint)rhs.number.i, MY_INTMAX, TYPE_INT);
+    case TYPE_UINT:  return int_npr(lhs.number.u, rhs.number.u, MY_UINTMAX, TYPE_UINT);
     default: break;
     }
     return lhs.unexpected_type();
@@ -1485,6 +2792,7 @@ static Value binop_max(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)MYMAX(lhs.number.f, rhs.number.f));
     case TYPE_INT:   return Value((Int)MYMAX(lhs.number.i, rhs.number.i));
     case TYPE_UINT:  return Value((Uint)MYMAX(lhs.number.u, rhs.number.u));
+    case TYPE_BIG:   return big_cmp(lhs.number.b, rhs.number.b) >= 0 ? lhs : rhs;
     default: break;
     }
     return lhs.unexpected_type();
@@ -1496,6 +2804,7 @@ static Value binop_min(Value& lhs, Value& rhs) noexcept {
     case TYPE_FLOAT: return Value((Float)MYMIN(lhs.number.f, rhs.number.f));
     case TYPE_INT:   return Value((Int)MYMIN(lhs.number.i, rhs.number.i));
     case TYPE_UINT:  return Value((Uint)MYMIN(lhs.number.u, rhs.number.u));
+    case TYPE_BIG:   return big_cmp(lhs.number.b, rhs.number.b) <= 0 ? lhs : rhs;
     default: break;
     }
     return lhs.unexpected_type();
@@ -1613,9 +2922,10 @@ static Value binop_atan2(Value& lhs, Value& rhs) noexcept {
 
 static Value unop_abs(Value& lhs) noexcept {
     switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)(lhs.number.f < FLOAT_ZERO ? (((Float)-1) * lhs.number.f) : lhs.number.f));
-    case TYPE_INT:   return Value((Int)(lhs.number.i < ((Int)0) ? (((Int)-1) * lhs.number.i) : lhs.number.i));
+    case TYPE_FLOAT: return Value((Float)(lhs.number.f < FLOAT_ZERO ? (Float)(((Float)-1) * lhs.number.f) : lhs.number.f));
+    case TYPE_INT:   return lhs.number.i < (Int)0 ? int_negate(REG_OP_ABS, lhs) : Value(lhs.number.i);
     case TYPE_UINT:  return Value(lhs.number.u);
+    case TYPE_BIG:   return Value(lhs.number.b->neg ? big_neg(lhs.number.b) : lhs.number.b);
     default: break;
     }
     return lhs.unexpected_type();
@@ -1699,13 +3009,16 @@ static Value unop_ord(Value &lhs) noexcept {
     char buf[512];
     switch (lhs.type) {
     case TYPE_FLOAT:
-        snprintf(buf, sizeof(buf), FMT_FLOAT, lhs.number.f);
+        // only the first character is wanted, the digits of a large one are cut
+        if (snprintf(buf, sizeof(buf), FMT_FLOAT, FLOAT_ARG(lhs.number.f)) < 0) {
+            buf[0] = 0;
+        }
         return Value((Int)buf[0]);
     case TYPE_INT:
-        snprintf(buf, sizeof(buf), FMT_INT, lhs.number.i);
+        snprintf(buf, sizeof(buf), FMT_INT, INT_ARG(lhs.number.i));
         return Value((Int)buf[0]);
     case TYPE_UINT:
-        snprintf(buf, sizeof(buf), FMT_UINT, lhs.number.u);
+        snprintf(buf, sizeof(buf), FMT_UINT, UINT_ARG(lhs.number.u));
         return Value((Int)buf[0]);
     case TYPE_STRING:
         return Value((Int)lhs.number.s[0]); // ascii only :/
@@ -1734,30 +3047,44 @@ static Value unop_log(Value &lhs) noexcept {
     return lhs.unexpected_type();
 }
 
+// the fields of a float of the word by the masks, whatever the endianness
+struct FloatParts {
+    Uint sign;
+    Uint exponent;
+    Uint mantissa;
+};
+
+static FloatParts float_parts(Uint bits) noexcept {
+    FloatParts parts;
+    parts.sign = (Uint)(bits >> (sizeof(Uint) * 8 - 1));
+    parts.exponent = (Uint)((bits >> MY_FEXPBIT) & MY_FEXPMASK);
+    parts.mantissa = (Uint)(bits & MY_FMANTMASK);
+    return parts;
+}
+
 static Value unop_info(Value &lhs) noexcept {
     switch (lhs.type) {
     case TYPE_FLOAT: {
-        FloatInfo fi;
-        fi.f = lhs.number.f;
-        // Note the sizing of these parts is weird. This works:
-        fprintf(stdout, "%u, %u, " FMT_UINT "\n",
-            (unsigned)fi.parts.sign, (unsigned)fi.parts.exponent, fi.parts.mantissa);
-        fprintf(stdout, "%d, 0x%X, 0x" FMT_HEX "\n",
-            (signed)fi.parts.sign, (unsigned)fi.parts.exponent, fi.parts.mantissa);
-        fflush(stdout);
+        FloatParts fi = float_parts(lhs.number.u);
+        fprintf(rpn_stdout(), "%u, %u, " FMT_UINT "\n",
+            (unsigned)fi.sign, (unsigned)fi.exponent, UINT_ARG(fi.mantissa));
+        fprintf(rpn_stdout(), "%d, 0x%X, 0x" FMT_HEX "\n",
+            (signed)fi.sign, (unsigned)fi.exponent, HEX_ARG(fi.mantissa));
+        fflush(rpn_stdout());
         return lhs;
     }
     case TYPE_INT: {
         lhs.println();
         return lhs;
     }
-    case TYPE_UINT: {
+    case TYPE_UINT:
+    case TYPE_BIG: {
         lhs.println();
         return lhs;
     }
     case TYPE_STRING:
-        fprintf(stdout, "%s\n", lhs.number.s);
-        fflush(stdout);
+        fprintf(rpn_stdout(), "%s\n", lhs.number.s);
+        fflush(rpn_stdout());
         return lhs;
     default:
         break;
@@ -1766,36 +3093,33 @@ static Value unop_info(Value &lhs) noexcept {
 }
 
 static Value unop_fsgn(Value &lhs) noexcept {
-    FloatInfo fi;
-    fi.f = lhs.number.f;
+    FloatParts fi = float_parts(lhs.number.u);
     switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Int)(fi.parts.sign));
-    case TYPE_INT:   return Value((Int)(fi.parts.sign));
-    case TYPE_UINT:  return Value((Int)(fi.parts.sign));
+    case TYPE_FLOAT: return Value((Int)(fi.sign));
+    case TYPE_INT:   return Value((Int)(fi.sign));
+    case TYPE_UINT:  return Value((Int)(fi.sign));
     default: break;
     }
     return lhs.unexpected_type();
 }
 
 static Value unop_fexp(Value &lhs) noexcept {
-    FloatInfo fi;
-    fi.f = lhs.number.f;
+    FloatParts fi = float_parts(lhs.number.u);
     switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Int)(fi.parts.exponent));
-    case TYPE_INT:   return Value((Int)(fi.parts.exponent));
-    case TYPE_UINT:  return Value((Int)(fi.parts.exponent));
+    case TYPE_FLOAT: return Value((Int)(fi.exponent));
+    case TYPE_INT:   return Value((Int)(fi.exponent));
+    case TYPE_UINT:  return Value((Int)(fi.exponent));
     default: break;
     }
     return lhs.unexpected_type();
 }
 
 static Value unop_fmant(Value &lhs) noexcept {
-    FloatInfo fi;
-    fi.f = lhs.number.f;
+    FloatParts fi = float_parts(lhs.number.u);
     switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Int)(fi.parts.mantissa));
-    case TYPE_INT:   return Value((Int)(fi.parts.mantissa));
-    case TYPE_UINT:  return Value((Int)(fi.parts.mantissa));
+    case TYPE_FLOAT: return Value((Int)(fi.mantissa));
+    case TYPE_INT:   return Value((Int)(fi.mantissa));
+    case TYPE_UINT:  return Value((Int)(fi.mantissa));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1803,24 +3127,23 @@ static Value unop_fmant(Value &lhs) noexcept {
 
 static Value unop_factorial(Value &lhs) noexcept {
     switch (lhs.type) {
-    case TYPE_FLOAT: {
-        Float result;
-        FACTORIAL(result, lhs.number.f);
-        return Value(result);
-    }
-    case TYPE_INT: {
-        Int result;
-        FACTORIAL(result, lhs.number.i);
-        return Value(result);
-    }
-    case TYPE_UINT: {
-        Uint result;
-        FACTORIAL_CHK(result, lhs.number.u, false);
-        return Value(result);
-    }
-    default: break;
+    case TYPE_FLOAT:
+        if (lhs.number.f < 0) {
+            break;
+        }
+        return Value((Float)float_factorial(lhs.number.f));
+    case TYPE_INT:
+        if (lhs.number.i < 0) {
+            break;
+        }
+        return int_factorial((Uint)lhs.number.i, MY_INTMAX, TYPE_INT);
+    case TYPE_UINT:
+        return int_factorial(lhs.number.u, MY_UINTMAX, TYPE_UINT);
+    default:
+        return lhs.unexpected_type();
     }
-    return lhs.unexpected_type();
+    EPRINT("factorial: value must be nonnegative\n");
+    rpn_exit(1);
 }
 
 static Value unop_inverse(Value &lhs) noexcept {
@@ -1833,23 +3156,67 @@ static Value unop_inverse(Value &lhs) noexcept {
     return lhs.unexpected_type();
 }
 
-// https://stackoverflow.com/questions/65401101/what-is-the-fastest-way-to-count-all-set-bits
-static Uint count_bits(Uint number)
-{
-    Uint lookup[16]={0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4};
-    Uint count = 0;
-    while (number != 0) {
-        count += lookup[number & 0xF];
-        number >>= 4;
+static Uint count_bits(Uint number) noexcept {
+    return (Uint)word_popcount(WORD_MASK(number));
+}
+
+// a 0 has all of its bits leading and trailing
+static Uint count_leading(Uint number) noexcept {
+#if defined(RPN_128BITS)
+    if (WORD_HI(number)) {
+        return (Uint)__builtin_clzll(WORD_HI(number));
+    }
+    return (Uint)(WORD_LO(number) ? 64 + __builtin_clzll(WORD_LO(number)) : 128);
+#else
+    number = WORD_MASK(number);
+    return number ? (Uint)(__builtin_clzll(number) - WORD_SHIFT) : WORD_BITS;
+#endif
+}
+
+static Uint count_trailing(Uint number) noexcept {
+#if defined(RPN_128BITS)
+    if (WORD_LO(number)) {
+        return (Uint)__builtin_ctzll(WORD_LO(number));
     }
-    return count;
+    return (Uint)(WORD_HI(number) ? 64 + __builtin_ctzll(WORD_HI(number)) : 128);
+#else
+    number = WORD_MASK(number);
+    return number ? (Uint)__builtin_ctzll(number) : WORD_BITS;
+#endif
+}
+
+// bytes swapped, then nibbles, pairs and bits within each byte
+static uint64_t reverse64(uint64_t v) noexcept {
+    v = __builtin_bswap64(v);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+    v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+    v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+    return v;
+}
+
+#if defined(RPN_128BITS)
+static Uint byte_swap(Uint number) noexcept {
+    return WORD_OF(__builtin_bswap64(WORD_LO(number)), __builtin_bswap64(WORD_HI(number)));
+}
+
+static Uint bit_reverse(Uint number) noexcept {
+    return WORD_OF(reverse64(WORD_LO(number)), reverse64(WORD_HI(number)));
+}
+#else
+static Uint byte_swap(Uint number) noexcept {
+    return (Uint)(__builtin_bswap64(WORD_MASK(number)) >> WORD_SHIFT);
+}
+
+static Uint bit_reverse(Uint number) noexcept {
+    return (Uint)(reverse64(WORD_MASK(number)) >> WORD_SHIFT);
 }
+#endif
 
 static Value unop_clearbits(Value &lhs) noexcept {
     switch (lhs.type) {
-    case TYPE_FLOAT: return Value((Float)( sizeof(Uint)*8 - count_bits(lhs.number.u) ));
-    case TYPE_INT:   return Value((Int)( sizeof(Uint)*8 - count_bits(lhs.number.u) ));
-    case TYPE_UINT:  return Value((Uint)( sizeof(Uint)*8 - count_bits(lhs.number.u) ));
+    case TYPE_FLOAT: return Value((Float)( WORD_BITS - count_bits(lhs.number.u) ));
+    case TYPE_INT:   return Value((Int)( WORD_BITS - count_bits(lhs.number.u) ));
+    case TYPE_UINT:  return Value((Uint)( WORD_BITS - count_bits(lhs.number.u) ));
     default: break;
     }
     return lhs.unexpected_type();
@@ -1865,6 +3232,189 @@ static Value unop_setbits(Value &lhs) noexcept {
     return lhs.unexpected_type();
 }
 
+static Value unop_clz(Value &lhs) noexcept {
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)count_leading(lhs.number.u));
+    case TYPE_INT:   return Value((Int)count_leading(lhs.number.u));
+    case TYPE_UINT:  return Value((Uint)count_leading(lhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value unop_ctz(Value &lhs) noexcept {
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)count_trailing(lhs.number.u));
+    case TYPE_INT:   return Value((Int)count_trailing(lhs.number.u));
+    case TYPE_UINT:  return Value((Uint)count_trailing(lhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value unop_bswap(Value &lhs) noexcept {
+    whole_bytes(REG_OP_BSWAP);
+    switch (lhs.type) {
+    case TYPE_FLOAT: {
+        Value tmp = Value(byte_swap(lhs.number.u));
+        tmp.pun(TYPE_FLOAT);
+        return tmp;
+    }
+    case TYPE_INT:   return Value((Int)byte_swap(lhs.number.u));
+    case TYPE_UINT:  return Value(byte_swap(lhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value unop_bitrev(Value &lhs) noexcept {
+    switch (lhs.type) {
+    case TYPE_FLOAT: {
+        Value tmp = Value(bit_reverse(lhs.number.u));
+        tmp.pun(TYPE_FLOAT);
+        return tmp;
+    }
+    case TYPE_INT:   return Value((Int)bit_reverse(lhs.number.u));
+    case TYPE_UINT:  return Value(bit_reverse(lhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value unop_parity(Value &lhs) noexcept {
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)(count_bits(lhs.number.u) & 1));
+    case TYPE_INT:   return Value((Int)(count_bits(lhs.number.u) & 1));
+    case TYPE_UINT:  return Value((Uint)(count_bits(lhs.number.u) & 1));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+static Value unop_isprime(Value &lhs) noexcept {
+    limit_64(REG_OP_ISPRIME, lhs);
+    switch (lhs.type) {
+    case TYPE_FLOAT: return Value((Float)(lhs.number.f >= 0 && is_prime((uint64_t)lhs.number.f)));
+    case TYPE_INT:   return Value((Int)(lhs.number.i >= 0 && is_prime((uint64_t)lhs.number.i)));
+    case TYPE_UINT:  return Value((Uint)is_prime(lhs.number.u));
+    default: break;
+    }
+    return lhs.unexpected_type();
+}
+
+// n, its prime factors pushed largest first so the smallest is on top, with
+// a -1 above those of a negative n. 0 and 1 are their own.
+static void stackop_factor(std::stack<Value>& stack) noexcept {
+    Value n = maybe_a_constant(stack.top());
+    stack.pop();
+    limit_64(REG_OP_FACTOR, n);
+    bool negative = false;
+    uint64_t magnitude = 0;
+    switch (n.type) {
+    case TYPE_FLOAT:
+        negative = n.number.f < 0;
+        magnitude = negative ? (uint64_t)-n.number.f : (uint64_t)n.number.f;
+        break;
+    case TYPE_INT:
+        negative = n.number.i < 0;
+        magnitude = (uint64_t)(negative ? (Uint)((Uint)0 - (Uint)n.number.i) : (Uint)n.number.i);
+        break;
+    case TYPE_UINT:
+        magnitude = (uint64_t)n.number.u;
+        break;
+    default:
+        n.unexpected_type();
+    }
+    if (magnitude < 2) {
+        stack.push(n);
+        return;
+    }
+
+    uint64_t factors[64];
+    for (unsigned i = factorize(magnitude, factors); i-- > 0;) {
+        switch (n.type) {
+        case TYPE_FLOAT: stack.push(Value((Float)factors[i])); break;
+        case TYPE_INT:   stack.push(Value((Int)factors[i])); break;
+        default:         stack.push(Value((Uint)factors[i])); break;
+        }
+    }
+    if (negative) {
+        stack.push(n.type == TYPE_FLOAT ? Value((Float)-1) : Value((Int)-1));
+    }
+}
+
+/**
+ * Status flags of the add, sub, mul and shl instructions, to check an
+ * emulator or firmware against: addf, subf, mulf and shlf push the result
+ * as the plain operation would, then its flags word of Flag. Operands are
+ * the bits of the word, the result has the type of the first. C is the
+ * carry out of add, the borrow of sub, the last bit shifted out by shl and
+ * an unsigned product past the word for mul, V a signed result past it.
+ */
+
+static void flags_operands(const char *op, std::stack<Value>& stack, Value *lhs, Value *rhs) noexcept {
+    if (stack.size() < 2) {
+        EPRINT("%s: Invalid stack\n", op);
+        rpn_exit(1);
+    }
+    *rhs = maybe_a_constant(stack.top());
+    stack.pop();
+    *lhs = maybe_a_constant(stack.top());
+    stack.pop();
+}
+
+static void flags_push(std::stack<Value>& stack, Value& lhs, Uint result, bool carry, bool overflow) noexcept {
+    Uint r = WORD_MASK(result);
+    unsigned flags = (overflow ? FLAG_V : 0) | (carry ? FLAG_C : 0) | (r == 0 ? FLAG_Z : 0) |
+        ((r >> (WORD_BITS - 1)) & 1 ? FLAG_N : 0);
+    Value f = Value((Uint)flags);
+    f.format(FORMAT_BIN);
+    stack.push(word_fit(bits_as(r, lhs)));
+    stack.push(f);
+}
+
+// the top bit of the word
+static bool sign_of(Uint bits) noexcept {
+    return (bits >> (WORD_BITS - 1)) & 1;
+}
+
+static void stackop_addf(std::stack<Value>& stack) noexcept {
+    Value lhs, rhs;
+    flags_operands(REG_OP_ADDF, stack, &lhs, &rhs);
+    Uint a = bits_of(lhs), b = bits_of(rhs), r;
+    bool wrapped = __builtin_add_overflow(a, b, &r);
+    bool carry = uint_overflows(wrapped, r);
+    flags_push(stack, lhs, r, carry, sign_of((a ^ r) & (b ^ r)));
+}
+
+static void stackop_subf(std::stack<Value>& stack) noexcept {
+    Value lhs, rhs;
+    flags_operands(REG_OP_SUBF, stack, &lhs, &rhs);
+    Uint a = bits_of(lhs), b = bits_of(rhs), r;
+    bool borrow = __builtin_sub_overflow(a, b, &r);
+    flags_push(stack, lhs, r, borrow, sign_of((a ^ b) & (a ^ r)));
+}
+
+static void stackop_mulf(std::stack<Value>& stack) noexcept {
+    Value lhs, rhs;
+    flags_operands(REG_OP_MULF, stack, &lhs, &rhs);
+    Uint a = bits_of(lhs), b = bits_of(rhs), r;
+    Int p;
+    bool wrapped = __builtin_mul_overflow(a, b, &r);
+    bool carry = uint_overflows(wrapped, r);
+    wrapped = __builtin_mul_overflow(word_signed(a), word_signed(b), &p);
+    bool overflow = int_overflows(wrapped, p);
+    flags_push(stack, lhs, r, carry, overflow);
+}
+
+static void stackop_shlf(std::stack<Value>& stack) noexcept {
+    Value lhs, rhs;
+    flags_operands(REG_OP_SHLF, stack, &lhs, &rhs);
+    Uint a = bits_of(lhs), n = count_of(rhs);
+    bool carry = n >= 1 && n <= WORD_BITS && ((a >> (WORD_BITS - n)) & 1);
+    flags_push(stack, lhs, shift_left(a, n), carry, shl_overflows(a, n, true));
+}
+
 static bool op_isunary(SymOp op) noexcept {
     for (size_t i = 0; unopTable[i] != NULL; i++) {
         if (unopTable[i] == (SymUnop)op) {
@@ -1874,6 +3424,24 @@ static bool op_isunary(SymOp op) noexcept {
     return false;
 }
 
+static bool op_isstackop(SymOp op) noexcept {
+    for (size_t i = 0; stackopTable[i] != NULL; i++) {
+        if (stackopTable[i] == (SymStackop)op) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static unsigned op_arity(SymOp op) noexcept {
+    for (size_t i = 0; naryTable[i].op != NULL; i++) {
+        if (naryTable[i].op == (SymNaryop)op) {
+            return naryTable[i].arity;
+        }
+    }
+    return op_isunary(op) ? 1 : 2;
+}
+
 #if 0
 static bool op_isbinary(SymOp op) noexcept {
     return !op_isunary(op);
@@ -1896,7 +3464,6 @@ Value::Value(const char *value) noexcept :
     number.s = value;
 }
 
-#ifndef NO_FLOAT
 Value::Value(Float f) noexcept :
     number{0},
     type{TYPE_FLOAT},
@@ -1904,7 +3471,15 @@ Value::Value(Float f) noexcept :
 {
     number.f = f;
 }
-#endif
+
+Value::Value(const Big *b) noexcept :
+    number{0},
+    type{TYPE_BIG},
+    fmt{FORMAT_DEC}
+{
+    assert(b);
+    number.b = b;
+}
 
 Value::Value(Int i) noexcept :
     number{0},
@@ -1922,51 +3497,72 @@ Value::Value(Uint u) noexcept :
     number.u = u;
 }
 
-#define LONG_PRINTF(prefix, longformat, format, value, end) \
+// Kind is FLOAT, HEX or OCT, of the FMT_* and *_ARG pairs
+#define LONG_PRINTF(prefix, Kind, value, end) \
 do { \
     if (_longform) { \
-        fprintf(stdout, prefix longformat "%s", value, end); \
+        fprintf(rpn_stdout(), prefix FMT_LONG_ ## Kind "%s", LONG_ ## Kind ## _ARG(value), end); \
     } else { \
-        fprintf(stdout, prefix format "%s", value, end); \
+        fprintf(rpn_stdout(), prefix FMT_ ## Kind "%s", Kind ## _ARG(value), end); \
     } \
 } while (0)
 
+// digits of any length in the base of the format, the endian and chr
+// formats of a word print hex and dec
+static void print_big(Value& v, const char *end) noexcept {
+    unsigned base = 10;
+    const char *prefix = "";
+    switch (v.fmt) {
+    case FORMAT_HEX:
+    case FORMAT_BIG:
+    case FORMAT_LITTLE: base = 16; prefix = "0x"; break;
+    case FORMAT_OCT:    base = 8;  prefix = "0o"; break;
+    case FORMAT_BIN:    base = 2;  prefix = "0b"; break;
+    default: break;
+    }
+    std::string digits = big_to_string(v.number.b, base);
+    bool neg = digits[0] == '-';
+    fprintf(rpn_stdout(), "%s%s%s%s", neg ? "-" : "", prefix, digits.c_str() + neg, end);
+}
+
 static void do_print(Value& v, const char *end) noexcept {
     assert(end != NULL);
+    if (v.type == TYPE_BIG && v.fmt != FORMAT_TYPE) {
+        print_big(v, end);
+        fflush(rpn_stdout());
+        return;
+    }
+    // an int of 'hd --bits' without the copies of its sign past the word
+    Uint bits = v.type == TYPE_INT ? WORD_MASK(v.number.u) : v.number.u;
     switch (v.fmt) {
     case FORMAT_DEC:
         switch (v.type) {
         case TYPE_FLOAT:
-            #ifdef FMT_LONG_FLOAT
-                LONG_PRINTF("", FMT_LONG_FLOAT, FMT_FLOAT, v.number.f, end);
-            #else
-                fprintf(stdout, FMT_FLOAT "%s", v.number.f, end);
-            #endif
-
+            LONG_PRINTF("", FLOAT, v.number.f, end);
             break;
         case TYPE_INT:
-            fprintf(stdout, FMT_INT "%s", v.number.i, end);
+            fprintf(rpn_stdout(), FMT_INT "%s", INT_ARG(v.number.i), end);
             break;
         case TYPE_UINT:
-            fprintf(stdout, FMT_UINT "%s", v.number.u, end);
+            fprintf(rpn_stdout(), FMT_UINT "%s", UINT_ARG(v.number.u), end);
             break;
         }
         break;
     case FORMAT_HEX:
     hex:
-        LONG_PRINTF("0x", FMT_LONG_HEX, FMT_HEX, v.number.u, end);
+        LONG_PRINTF("0x", HEX, bits, end);
         break;
     case FORMAT_OCT:
-        LONG_PRINTF("0o", FMT_LONG_OCT, FMT_OCT, v.number.u, end);
+        LONG_PRINTF("0o", OCT, bits, end);
         break;
     case FORMAT_BIN:
-        print_binary(v.number.u);
-        fprintf(stdout, "%s", end);
+        print_binary(bits);
+        fprintf(rpn_stdout(), "%s", end);
         break;
     case FORMAT_BIG:
         if (is_little_endian()) {
-            print_reversed(v.number.u);
-            fprintf(stdout, "%s", end);
+            print_reversed(bits);
+            fprintf(rpn_stdout(), "%s", end);
             break;
         }
         else {
@@ -1974,8 +3570,8 @@ static void do_print(Value& v, const char *end) noexcept {
         }
     case FORMAT_LITTLE:
         if (is_big_endian()) {
-            print_reversed(v.number.u);
-            fprintf(stdout, "%s", end);
+            print_reversed(bits);
+            fprintf(rpn_stdout(), "%s", end);
             break;
         }
         else {
@@ -1984,24 +3580,33 @@ static void do_print(Value& v, const char *end) noexcept {
     case FORMAT_CHAR:
         switch (v.type) {
         case TYPE_FLOAT:
-            fprintf(stdout, "%s%s", ascii_lookup(v.number.f), end);
+            fprintf(rpn_stdout(), "%s%s", ascii_lookup(v.number.f), end);
             break;
         case TYPE_INT:
-            fprintf(stdout, "%s%s", ascii_lookup(v.number.i), end);
+            fprintf(rpn_stdout(), "%s%s", ascii_lookup(v.number.i), end);
             break;
         case TYPE_UINT:
-            fprintf(stdout, "%s%s", ascii_lookup(v.number.u), end);
+            fprintf(rpn_stdout(), "%s%s", ascii_lookup(v.number.u), end);
             break;
         }
         break;
     case FORMAT_TYPE:
-        fprintf(stdout, "%s%s", typeTable[v.type], end);
+        fprintf(rpn_stdout(), "%s%s", typeTable[v.type], end);
+        break;
+    case FORMAT_LANES8:
+        print_lanes(v, 8, end);
+        break;
+    case FORMAT_LANES16:
+        print_lanes(v, 16, end);
+        break;
+    case FORMAT_LANES32:
+        print_lanes(v, 32, end);
         break;
     default:
         assert(0);
         break;
     }
-    fflush(stdout);
+    fflush(rpn_stdout());
 }
 
 void Value::print() noexcept {
@@ -2015,32 +3620,57 @@ void Value::println() noexcept {
 static void print_binary(Uint value) noexcept {
     int size = (int)sizeof(Uint) * 8 - 1;
 
-    fprintf(stdout, "0b");
-    fflush(stdout);
+    fprintf(rpn_stdout(), "0b");
+    fflush(rpn_stdout());
     for (int i = size; i >= 0; i--) {
-        if (!_longform && ((Uint)(((Uint)1) << (Uint)i) > value)) {
+        // --long pads to the word, a float of 'hd --bits' can go past it
+        if ((!_longform || i >= (int)WORD_BITS) && ((Uint)(((Uint)1) << (Uint)i) > value)) {
             continue;
         }
-        fprintf(stdout, "%u", (unsigned)((value >> i) & 1));
-        fflush(stdout);
+        fprintf(rpn_stdout(), "%u", (unsigned)((value >> i) & 1));
+        fflush(rpn_stdout());
+    }
+    if (value == 0 && !_longform) {
+        fprintf(rpn_stdout(), "0");
     }
 }
 
 static void print_reversed(Uint value) noexcept {
-    Uint reversed = 0;
-    int size = (int)sizeof(Uint);
-    uint8_t *forward = (uint8_t *)&value;
-    uint8_t *backward = (uint8_t *)&reversed;
-
-    for (int i = 0; i < size; i++) {
-        backward[i] = forward[size - i - 1];
+    fprintf(rpn_stdout(), "0x" FMT_HEX, HEX_ARG(byte_swap(value)));
+    fflush(rpn_stdout());
+}
+
+// the lanes of the word lowest first, as a debugger shows a vector register:
+// signed for an int, floats of the lane's size for a float. A lane past the
+// top of the word has only the bits left.
+static void print_lanes(Value& v, unsigned lane, const char *end) noexcept {
+    Uint bits = WORD_MASK(v.number.u);
+    fprintf(rpn_stdout(), "{");
+    for (unsigned pos = 0; pos < (unsigned)WORD_BITS; pos += lane) {
+        unsigned size = MYMIN(lane, (unsigned)WORD_BITS - pos);
+        uint64_t u = (uint64_t)(bits >> pos) & (((uint64_t)1 << size) - 1);
+        const char *sep = pos ? "," : "";
+        if (v.type == TYPE_FLOAT && size == lane) {
+            float f;
+            uint32_t u32 = (uint32_t)u;
+            switch (lane) {
+            case 8: f = fp8_to_float((uint8_t)u, _fp8e5m2); break;
+            case 16: f = _bfloat16 ? bf16_to_float((uint16_t)u) : half_to_float((uint16_t)u); break;
+            default: memcpy(&f, &u32, sizeof(f)); break;
+            }
+            fprintf(rpn_stdout(), "%s%g", sep, (double)f);
+        }
+        else if (v.type == TYPE_INT) {
+            fprintf(rpn_stdout(), "%s%lld", sep, (long long)((int64_t)(u << (64 - size)) >> (64 - size)));
+        }
+        else {
+            fprintf(rpn_stdout(), "%s%llu", sep, (unsigned long long)u);
+        }
     }
-
-    fprintf(stdout, "0x" FMT_HEX, reversed);
-    fflush(stdout);
+    fprintf(rpn_stdout(), "}%s", end);
 }
 
-// must be formatted properly by some regex
+// must be formatted properly by lex_binary or lex_binary_post
 static bool conve_binary(const char *value, Uint *out) noexcept {
     assert(value);
     assert(out);
@@ -2067,6 +3697,10 @@ static bool conve_binary(const char *value, Uint *out) noexcept {
 }
 
 enum Type Value::coerce_chk(Value& other) noexcept {
+    if (this->type == TYPE_BIG || other.type == TYPE_BIG) {
+        Type rest = this->type == TYPE_BIG ? other.type : this->type;
+        return rest == TYPE_FLOAT || rest == TYPE_STRING ? rest : TYPE_BIG;
+    }
     if (this->type == TYPE_INT && other.type == TYPE_UINT) {
         if (this->number.i < (Int)0) {
             return this->type;
@@ -2097,6 +3731,9 @@ void Value::coerce_exec(enum Type type) noexcept {
         case TYPE_UINT: // up convert
             this->number.f = (Float)this->number.u;
             break;
+        case TYPE_BIG: // up convert
+            this->number.f = (Float)big_to_double(this->number.b);
+            break;
         }
         break;
     case TYPE_INT: switch (this->type) {
@@ -2106,6 +3743,9 @@ void Value::coerce_exec(enum Type type) noexcept {
         case TYPE_UINT: // down convert
             this->number.i = (Int)this->number.u;
             break;
+        case TYPE_BIG: // down convert, wrapping
+            this->number.i = (Int)big_word(this->number.b);
+            break;
        }
        break;
     case TYPE_UINT: switch (this->type) {
@@ -2115,12 +3755,31 @@ void Value::coerce_exec(enum Type type) noexcept {
         case TYPE_INT: // up convert
             this->number.u = (Uint)this->number.i;
             break;
+        case TYPE_BIG: // down convert, wrapping
+            this->number.u = big_word(this->number.b);
+            break;
+        }
+        break;
+    case TYPE_BIG: switch (this->type) {
+        case TYPE_FLOAT: // down convert
+            this->number.b = big_from_double((double)this->number.f);
+            break;
+        case TYPE_INT: // up convert
+            this->number.b = big_from_int((int64_t)this->number.i);
+            break;
+        case TYPE_UINT: // up convert
+            this->number.b = big_from_uint((uint64_t)this->number.u);
+            break;
+        default:
+            EPRINT("coerce: %s cannot convert to %s\n",
+                typeTable[this->type], typeTable[type]);
+            rpn_exit(1);
         }
         break;
     default:
         EPRINT("coerce: %s cannot convert to %s\n",
             typeTable[this->type], typeTable[type]);
-        exit(1);
+        rpn_exit(1);
     }
     this->type = type;
 }
@@ -2141,24 +3800,36 @@ void Value::format(enum Format format) noexcept {
 Value Value::unexpected_type(void) noexcept {
     const char *name = typeTable[this->type];
     switch (this->type) {
-    case TYPE_FLOAT:  EPRINT("Unexpected %s: '" FMT_FLOAT "'\n", name, this->number.f); break;
-    case TYPE_INT:    EPRINT("Unexpected %s: '" FMT_INT "'\n", name, this->number.i); break;
-    case TYPE_UINT:   EPRINT("Unexpected %s: '" FMT_UINT "'\n", name, this->number.u); break;
+    case TYPE_FLOAT:  EPRINT("Unexpected %s: '" FMT_FLOAT "'\n", name, FLOAT_ARG(this->number.f)); break;
+    case TYPE_INT:    EPRINT("Unexpected %s: '" FMT_INT "'\n", name, INT_ARG(this->number.i)); break;
+    case TYPE_UINT:   EPRINT("Unexpected %s: '" FMT_UINT "'\n", name, UINT_ARG(this->number.u)); break;
     case TYPE_STRING: EPRINT("Unexpected %s: '" FMT_STRING "'\n", name, this->number.s); break;
+    case TYPE_BIG:    EPRINT("Unexpected %s: '%s'\n", name, big_to_string(this->number.b, 10).c_str()); break;
     default:          EPRINT("Unexpected unknown error\n"); break;
     }
-    exit(1);
+    rpn_exit(1);
     return Value();
 }
 
-#ifdef NO_FLOAT
-#undef NO_FLOAT
-#undef Float
-#else
 #undef FMT_LONG_FLOAT
-#endif
 
 #undef FMT_FLOAT
+#undef FLOAT_ARG
+#undef INT_ARG
+#undef UINT_ARG
+#undef HEX_ARG
+#undef OCT_ARG
+#undef LONG_FLOAT_ARG
+#undef LONG_HEX_ARG
+#undef LONG_OCT_ARG
+#undef PARSE_FLOAT
+#undef PARSE_INT
+#undef PARSE_UINT
+#undef WORD_GCD
+#undef WORD_LCM
+#undef WORD_POW
+#undef FLOAT_PI
+#undef FLOAT_E
 #undef FMT_INT
 #undef FMT_UINT
 #undef FMT_HEX
@@ -2187,6 +3858,12 @@ Value Value::unexpected_type(void) noexcept {
 #undef MY_FLOATMAX
 #undef MY_FLOATMIN
 #undef MY_BITMAX
+#undef WORD_BITS
+#undef WORD_SHIFT
+#undef WORD_MASK
+#undef WORD_LO
+#undef WORD_HI
+#undef WORD_OF
 #undef MY_FMANTMASK
 #undef MY_FEXPMASK
 #undef MY_FEXPBIT
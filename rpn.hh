@@ -1,11 +1,12 @@
 #include <stack>
 #include <string>
-#include <iostream>
 #include <new>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <regex>
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
@@ -18,7 +19,15 @@
 #include <inttypes.h>
 #endif
 
+#include "big.hpp"
+#include "bits.hpp"
+#include "cpu.hpp"
+#include "image.hpp"
+#include "lanes.hpp"
+#include "minifloat.hpp"
+#include "quad.hpp"
 #include "rpn.hpp"
+#include "store.hpp"
 #include "util.hpp"
 
 #ifndef M_PI
@@ -28,3 +37,148 @@
 #ifndef M_E
 #define M_E 2.71828182845904523536
 #endif
+
+// every operation as X(name, function), in the order images number them.
+// The names are shared by the widths, each has its own functions.
+#define RPN_OPERATIONS(X) \
+    X(REG_OP_ADD_SYM, binop_add) \
+    X(REG_OP_ADD, binop_add) \
+    X(REG_OP_SUB_SYM, binop_sub) \
+    X(REG_OP_SUB, binop_sub) \
+    X(REG_OP_MUL_SYM, binop_mul) \
+    X(REG_OP_MUL, binop_mul) \
+    X(REG_OP_DIV_SYM, binop_div) \
+    X(REG_OP_DIV, binop_div) \
+    X(REG_OP_MOD_SYM, binop_mod) \
+    X(REG_OP_MOD, binop_mod) \
+    X(REG_OP_BITXOR_SYM, binop_bitxor) \
+    X(REG_OP_BITXOR, binop_bitxor) \
+    X(REG_OP_BITAND_SYM, binop_bitand) \
+    X(REG_OP_BITAND, binop_bitand) \
+    X(REG_OP_BITOR_SYM, binop_bitor) \
+    X(REG_OP_BITOR, binop_bitor) \
+    X(REG_OP_BITCLEAR_SYM, binop_bitclear) /* a & ~b */ \
+    X(REG_OP_BITCLEAR, binop_bitclear) \
+    X(REG_OP_NOT_SYM, unop_not) \
+    X(REG_OP_NOT, unop_not) \
+    X(REG_OP_INV_SYM, unop_inv) \
+    X(REG_OP_INV, unop_inv) \
+    X(REG_OP_AND_SYM, binop_and) \
+    X(REG_OP_AND, binop_and) \
+    X(REG_OP_OR_SYM, binop_or) \
+    X(REG_OP_OR, binop_or) \
+    X(REG_OP_XOR_SYM, binop_xor) \
+    X(REG_OP_XOR, binop_xor) \
+    X(REG_OP_POW_SYM, binop_pow) \
+    X(REG_OP_POW, binop_pow) \
+    X(REG_OP_SHL_SYM, binop_shl) \
+    X(REG_OP_SHL, binop_shl) \
+    X(REG_OP_LSH, binop_shl) \
+    X(REG_OP_SHR_SYM, binop_shr) \
+    X(REG_OP_SHR, binop_shr) \
+    X(REG_OP_RSH, binop_shr) \
+    X(REG_OP_EQ_SYM, binop_equ) \
+    X(REG_OP_EQ, binop_equ) \
+    X(REG_OP_EQU, binop_equ) \
+    X(REG_OP_NEQ_SYM, binop_neq) \
+    X(REG_OP_NEQ, binop_neq) \
+    X(REG_OP_GT_SYM, binop_gt) \
+    X(REG_OP_GT, binop_gt) \
+    X(REG_OP_GTE_SYM, binop_gte) \
+    X(REG_OP_GTE, binop_gte) \
+    X(REG_OP_LT_SYM, binop_lt) \
+    X(REG_OP_LT, binop_lt) \
+    X(REG_OP_LTE_SYM, binop_lte) \
+    X(REG_OP_LTE, binop_lte) \
+    X(REG_OP_END_SYM, unop_end) \
+    X(REG_OP_END, unop_end) \
+    X(REG_OP_SEP_SYM, unop_sep) \
+    X(REG_OP_SEP, unop_sep) \
+    X(REG_OP_QUIET, unop_quiet) \
+    X(REG_OP_CAST, binop_cast) \
+    X(REG_OP_AS, binop_pun) \
+    X(REG_OP_SQRT, unop_sqrt) \
+    X(REG_OP_GCD, binop_gcd) \
+    X(REG_OP_LCM, binop_lcm) \
+    X(REG_OP_ADDMOD, naryop_addmod) \
+    X(REG_OP_MULMOD, naryop_mulmod) \
+    X(REG_OP_POWMOD, naryop_powmod) \
+    X(REG_OP_INVMOD, binop_invmod) \
+    X(REG_OP_ISPRIME, unop_isprime) \
+    X(REG_OP_FACTOR, stackop_factor) \
+    X(REG_OP_ROR, binop_ror) \
+    X(REG_OP_ROL, binop_rol) \
+    X(REG_OP_SIN, unop_sin) \
+    X(REG_OP_COS, unop_cos) \
+    X(REG_OP_TAN, unop_tan) \
+    X(REG_OP_ASIN, unop_asin) \
+    X(REG_OP_ACOS, unop_acos) \
+    X(REG_OP_ATAN, unop_atan) \
+    X(REG_OP_ATAN2, binop_atan2) \
+    X(REG_OP_ABS, unop_abs) /* to + */ \
+    X(REG_OP_SGN, unop_sgn) \
+    X(REG_OP_FLOOR, unop_floor) \
+    X(REG_OP_ROUND, unop_round) \
+    X(REG_OP_CEIL, unop_ceil) \
+    X(REG_OP_TRUNC, unop_trunc) \
+    X(REG_OP_ORD, unop_ord) \
+    X(REG_OP_LN, unop_ln) \
+    X(REG_OP_LOG, unop_log) \
+    X(REG_OP_INFO, unop_info) \
+    X(REG_OP_FSGN, unop_fsgn) \
+    X(REG_OP_FEXP, unop_fexp) \
+    X(REG_OP_FMANT, unop_fmant) \
+    X(REG_OP_FACTORIAL, unop_factorial) \
+    X(REG_OP_INVERSE, unop_inverse) \
+    X(REG_OP_NCR, binop_ncr) \
+    X(REG_OP_NPR, binop_npr) \
+    X(REG_OP_SAVE, binop_save) \
+    X(REG_OP_MAX, binop_max) \
+    X(REG_OP_MIN, binop_min) \
+    X(REG_OP_CLEARBITS, unop_clearbits) \
+    X(REG_OP_SETBITS, unop_setbits) \
+    X(REG_OP_CLZ, unop_clz) \
+    X(REG_OP_CTZ, unop_ctz) \
+    X(REG_OP_BSWAP, unop_bswap) \
+    X(REG_OP_BITREV, unop_bitrev) \
+    X(REG_OP_PARITY, unop_parity) \
+    X(REG_OP_FSHL, naryop_fshl) \
+    X(REG_OP_FSHR, naryop_fshr) \
+    X(REG_OP_EXTRACT, naryop_extract) \
+    X(REG_OP_INSERT, naryop_insert) \
+    X(REG_OP_PDEP, binop_pdep) \
+    X(REG_OP_PEXT, binop_pext) \
+    X(REG_OP_INTERLEAVE, binop_interleave) \
+    X(REG_OP_INTERLEAVE3, naryop_interleave3) \
+    X(REG_OP_DEINTERLEAVE, binop_deinterleave) \
+    X(REG_OP_DEINTERLEAVE3, binop_deinterleave3) \
+    X(REG_OP_SEXT, binop_sext) \
+    X(REG_OP_LADD8, binop_ladd8) \
+    X(REG_OP_LADD16, binop_ladd16) \
+    X(REG_OP_LADD32, binop_ladd32) \
+    X(REG_OP_LSUB8, binop_lsub8) \
+    X(REG_OP_LSUB16, binop_lsub16) \
+    X(REG_OP_LSUB32, binop_lsub32) \
+    X(REG_OP_LSAT_ADD8, binop_lsat_add8) \
+    X(REG_OP_LSAT_ADD16, binop_lsat_add16) \
+    X(REG_OP_LSAT_ADD32, binop_lsat_add32) \
+    X(REG_OP_LSAT_SUB8, binop_lsat_sub8) \
+    X(REG_OP_LSAT_SUB16, binop_lsat_sub16) \
+    X(REG_OP_LSAT_SUB32, binop_lsat_sub32) \
+    X(REG_OP_LMIN8, binop_lmin8) \
+    X(REG_OP_LMIN16, binop_lmin16) \
+    X(REG_OP_LMIN32, binop_lmin32) \
+    X(REG_OP_LMAX8, binop_lmax8) \
+    X(REG_OP_LMAX16, binop_lmax16) \
+    X(REG_OP_LMAX32, binop_lmax32) \
+    X(REG_OP_LCMPEQ8, binop_lcmpeq8) \
+    X(REG_OP_LCMPEQ16, binop_lcmpeq16) \
+    X(REG_OP_LCMPEQ32, binop_lcmpeq32) \
+    X(REG_OP_LCMPGT8, binop_lcmpgt8) \
+    X(REG_OP_LCMPGT16, binop_lcmpgt16) \
+    X(REG_OP_LCMPGT32, binop_lcmpgt32) \
+    X(REG_OP_LSHUF8, binop_lshuf8) \
+    X(REG_OP_ADDF, stackop_addf) \
+    X(REG_OP_SUBF, stackop_subf) \
+    X(REG_OP_MULF, stackop_mulf) \
+    X(REG_OP_SHLF, stackop_shlf)
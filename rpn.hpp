@@ -1,6 +1,13 @@
 #ifndef HD_RPN_H
 #define HD_RPN_H
 
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "quad.hpp"
+
+// grammar of numeric literals, matched by the lex_* functions in rpn_include.cpp
 #define REG_BIN      "(0[bB][01]+)"
 #define REG_BIN_POST "([01]+[bB])"
 #define REG_OCT      "(0[oO][01234567]+)"
@@ -91,6 +98,12 @@
 #define REG_OP_SQRT "sqrt"
 #define REG_OP_GCD "gcd"
 #define REG_OP_LCM "lcm"
+#define REG_OP_ADDMOD "addmod"
+#define REG_OP_MULMOD "mulmod"
+#define REG_OP_POWMOD "powmod"
+#define REG_OP_INVMOD "invmod"
+#define REG_OP_ISPRIME "isprime"
+#define REG_OP_FACTOR "factor"
 #define REG_OP_ROR "ror"
 #define REG_OP_ROL "rol"
 #define REG_OP_SIN "sin"
@@ -120,8 +133,55 @@
 #define REG_OP_NPR "npr"
 
 #define REG_OP_SAVE "save"
+#define REG_OP_DEF "def"
+#define REG_OP_ENDDEF "enddef"
 #define REG_OP_CLEARBITS "clearbits"
 #define REG_OP_SETBITS "setbits"
+#define REG_OP_CLZ "clz"
+#define REG_OP_CTZ "ctz"
+#define REG_OP_BSWAP "bswap"
+#define REG_OP_BITREV "bitrev"
+#define REG_OP_PARITY "parity"
+#define REG_OP_FSHL "fshl"
+#define REG_OP_FSHR "fshr"
+#define REG_OP_EXTRACT "extract"
+#define REG_OP_INSERT "insert"
+#define REG_OP_PDEP "pdep"
+#define REG_OP_PEXT "pext"
+#define REG_OP_INTERLEAVE "interleave"
+#define REG_OP_INTERLEAVE3 "interleave3"
+#define REG_OP_DEINTERLEAVE "deinterleave"
+#define REG_OP_DEINTERLEAVE3 "deinterleave3"
+#define REG_OP_SEXT "sext"
+#define REG_OP_LADD8 "ladd8"
+#define REG_OP_LADD16 "ladd16"
+#define REG_OP_LADD32 "ladd32"
+#define REG_OP_LSUB8 "lsub8"
+#define REG_OP_LSUB16 "lsub16"
+#define REG_OP_LSUB32 "lsub32"
+#define REG_OP_LSAT_ADD8 "lsat_add8"
+#define REG_OP_LSAT_ADD16 "lsat_add16"
+#define REG_OP_LSAT_ADD32 "lsat_add32"
+#define REG_OP_LSAT_SUB8 "lsat_sub8"
+#define REG_OP_LSAT_SUB16 "lsat_sub16"
+#define REG_OP_LSAT_SUB32 "lsat_sub32"
+#define REG_OP_LMIN8 "lmin8"
+#define REG_OP_LMIN16 "lmin16"
+#define REG_OP_LMIN32 "lmin32"
+#define REG_OP_LMAX8 "lmax8"
+#define REG_OP_LMAX16 "lmax16"
+#define REG_OP_LMAX32 "lmax32"
+#define REG_OP_LCMPEQ8 "lcmpeq8"
+#define REG_OP_LCMPEQ16 "lcmpeq16"
+#define REG_OP_LCMPEQ32 "lcmpeq32"
+#define REG_OP_LCMPGT8 "lcmpgt8"
+#define REG_OP_LCMPGT16 "lcmpgt16"
+#define REG_OP_LCMPGT32 "lcmpgt32"
+#define REG_OP_LSHUF8 "lshuf8"
+#define REG_OP_ADDF "addf"
+#define REG_OP_SUBF "subf"
+#define REG_OP_MULF "mulf"
+#define REG_OP_SHLF "shlf"
 
 struct RpnVtable {
     void *(* create)() noexcept;
@@ -130,6 +190,12 @@ struct RpnVtable {
     void (* print)(void *self) noexcept;
     void (* destroy)(void *self) noexcept;
     void (* help)() noexcept;
+    void (* reset)(void *self) noexcept;
+    bool (* convert)(char *value) noexcept;
+    void (* push_token)(void *self, const char *token, size_t len) noexcept;
+    bool (* save)(void *self, FILE *file) noexcept;
+    bool (* load)(void *self, const void *data, size_t size) noexcept;
+    void (* map)(void *self, const void *data, size_t size, bool big_endian) noexcept;
 };
 
 #define RPN_VTABLE(Bits) RpnVtable{ \
@@ -139,8 +205,34 @@ struct RpnVtable {
     (void (*)(void *) noexcept)Rpn ##Bits::rpn_print, \
     (void (*)(void *) noexcept)Rpn ##Bits::rpn_destroy, \
     (void (*)() noexcept)Rpn ##Bits::rpn_help, \
+    (void (*)(void *) noexcept)Rpn ##Bits::rpn_reset, \
+    (bool (*)(char *) noexcept)Rpn ##Bits::rpn_convert, \
+    (void (*)(void *, const char *, size_t) noexcept)Rpn ##Bits::rpn_push_token, \
+    (bool (*)(void *, FILE *) noexcept)Rpn ##Bits::rpn_save, \
+    (bool (*)(void *, const void *, size_t) noexcept)Rpn ##Bits::rpn_load, \
+    (void (*)(void *, const void *, size_t, bool) noexcept)Rpn ##Bits::rpn_map, \
 }
 
+#ifdef HD_QUAD
+namespace Rpn128 {
+
+struct Rpn;
+Rpn *rpn_create() noexcept;
+void rpn_exec(Rpn *self) noexcept;
+void rpn_push(Rpn *self, char *value) noexcept;
+void rpn_print(Rpn *self) noexcept;
+void rpn_destroy(Rpn *self) noexcept;
+void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
+
+}
+#endif
+
 namespace Rpn64 {
 
 struct Rpn;
@@ -150,6 +242,12 @@ void rpn_push(Rpn *self, char *value) noexcept;
 void rpn_print(Rpn *self) noexcept;
 void rpn_destroy(Rpn *self) noexcept;
 void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
 
 }
 
@@ -162,6 +260,12 @@ void rpn_push(Rpn *self, char *value) noexcept;
 void rpn_print(Rpn *self) noexcept;
 void rpn_destroy(Rpn *self) noexcept;
 void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
 
 }
 
@@ -174,6 +278,12 @@ void rpn_push(Rpn *self, char *value) noexcept;
 void rpn_print(Rpn *self) noexcept;
 void rpn_destroy(Rpn *self) noexcept;
 void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
 
 }
 
@@ -186,14 +296,61 @@ void rpn_push(Rpn *self, char *value) noexcept;
 void rpn_print(Rpn *self) noexcept;
 void rpn_destroy(Rpn *self) noexcept;
 void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
 
 }
 
-void regex_init(void);
-void regex_cleanup(void);
-bool regex_is_initialized(void);
+namespace RpnWide {
+
+struct Rpn;
+Rpn *rpn_create() noexcept;
+void rpn_exec(Rpn *self) noexcept;
+void rpn_push(Rpn *self, char *value) noexcept;
+void rpn_print(Rpn *self) noexcept;
+void rpn_destroy(Rpn *self) noexcept;
+void rpn_help() noexcept;
+void rpn_reset(Rpn *self) noexcept;
+bool rpn_convert(char *value) noexcept;
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept;
+bool rpn_save(Rpn *self, FILE *file) noexcept;
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept;
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept;
+
+}
 
 extern bool _verbose;
 extern bool _longform;
+extern bool _bigint;
+extern bool _checked; // of 'hd --checked', integer results past the word are errors
+extern bool _bfloat16;
+extern bool _fp8e5m2;
+extern unsigned _bits; // of 'hd --bits', 0 for all 64, read by Rpn64 alone
+extern unsigned _wide; // of 'hd --wide', the bits of the vectors of RpnWide
+
+// Per-thread redirection of the engine. Output and errors go to the given
+// streams instead of stdout/stderr when set, and errors longjmp to the armed
+// trap with their exit status instead of terminating the process.
+extern thread_local FILE *_rpnout;
+extern thread_local FILE *_rpnerr;
+extern thread_local jmp_buf *_rpntrap;
+
+[[noreturn]] void rpn_exit(int status) noexcept;
+
+// variables saved to and found in this store too when set, see store.hpp
+struct Store;
+extern Store *_rpnstore;
+
+static inline FILE *rpn_stdout(void) noexcept {
+    return _rpnout ? _rpnout : stdout;
+}
+
+static inline FILE *rpn_stderr(void) noexcept {
+    return _rpnerr ? _rpnerr : stderr;
+}
 
 #endif // HD_RPN_H
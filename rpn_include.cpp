@@ -8,83 +8,413 @@
 #define EPRINT(...) \
 do { \
     if (_verbose) { \
-        fprintf(stderr, __VA_ARGS__); \
+        fprintf(rpn_stderr(), __VA_ARGS__); \
     } \
 } while (0)
 
-static std::regex *regex_unsigned;
-static std::regex *regex_signed;
-static std::regex *regex_float;
-static std::regex *regex_binary;
-static std::regex *regex_binary_post;
-static std::regex *regex_octal;
-static std::regex *regex_octal_pre;
-static std::regex *regex_octal_post;
-static std::regex *regex_hexadecimal;
-static std::regex *regex_hexadecimal_post;
-
-void regex_init(void)
-{
-#define XINIT(RegP, Regexp) do { \
-        if (!RegP) { \
-            RegP = new (std::nothrow) std::regex(Regexp); \
-            if (!RegP) { \
-                EPRINT("regex: out of memory\n"); \
-                exit(ENOMEM); \
-            } \
-        } \
-    } while (0)
-
-    XINIT(regex_unsigned, REG_UNSIGNED);
-    XINIT(regex_signed, REG_SIGNED);
-    XINIT(regex_float, REG_FLOAT);
-    XINIT(regex_binary, REG_BIN);
-    XINIT(regex_binary_post, REG_BIN_POST);
-    XINIT(regex_octal, REG_OCT);
-    XINIT(regex_octal_pre, REG_OCT_PRE);
-    XINIT(regex_octal_post, REG_OCT_POST);
-    XINIT(regex_hexadecimal, REG_HEX);
-    XINIT(regex_hexadecimal_post, REG_HEX_POST);
-
-#undef XINIT
-}
-
-void regex_cleanup(void)
-{
-#define XCLEANUP(RegP) do { \
-        if (RegP) { \
-            delete RegP; \
-            RegP = nullptr; \
-        } \
-    } while (0)
-
-    XCLEANUP(regex_unsigned);
-    XCLEANUP(regex_signed);
-    XCLEANUP(regex_float);
-    XCLEANUP(regex_binary);
-    XCLEANUP(regex_binary_post);
-    XCLEANUP(regex_octal);
-    XCLEANUP(regex_octal_pre);
-    XCLEANUP(regex_octal_post);
-    XCLEANUP(regex_hexadecimal);
-    XCLEANUP(regex_hexadecimal_post);
-
-#undef XCLEANUP
-}
-
-bool regex_is_initialized(void)
+thread_local FILE *_rpnout = NULL; // extern
+thread_local FILE *_rpnerr = NULL; // extern
+thread_local jmp_buf *_rpntrap = NULL; // extern
+Store *_rpnstore = NULL; // extern
+
+void rpn_exit(int status) noexcept
 {
-    return
-        regex_unsigned &&
-        regex_signed &&
-        regex_float &&
-        regex_binary &&
-        regex_binary_post &&
-        regex_octal &&
-        regex_octal_pre &&
-        regex_octal_post &&
-        regex_hexadecimal &&
-        regex_hexadecimal_post;
+    if (_rpntrap) {
+        fflush(rpn_stdout());
+        longjmp(*_rpntrap, status ? status : 1);
+    }
+    exit(status);
+}
+
+// the bit kernels for the CPU, picked once at startup
+static BitKernels bits_select() noexcept {
+    BitKernels kernels = bits_kernels(cpu_features());
+    cpu_select("bit ops", kernels.name);
+    cpu_select("bit deposit", kernels.deposit_name);
+    return kernels;
+}
+
+static const BitKernels bit_kernels = bits_select();
+
+static LaneKernels lanes_select() noexcept {
+    LaneKernels kernels = lane_kernels(cpu_features());
+    cpu_select("lane ops", kernels.name);
+    return kernels;
+}
+
+static const LaneKernels lane_ops = lanes_select();
+
+/**
+ * Literal lexers, each is a full match of the REG_* pattern of its name in
+ * rpn.hpp. Hand written since compiling the patterns dominated startup.
+ */
+
+static inline bool lex_isdigit(char c) noexcept { return '0' <= c && c <= '9'; }
+static inline bool lex_isnonzero(char c) noexcept { return '1' <= c && c <= '9'; }
+static inline bool lex_isoct(char c) noexcept { return '0' <= c && c <= '7'; }
+static inline bool lex_isbin(char c) noexcept { return c == '0' || c == '1'; }
+static inline bool lex_issign(char c) noexcept { return c == '+' || c == '-'; }
+static inline bool lex_ishex(char c) noexcept {
+    return lex_isdigit(c) || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F');
+}
+
+// one or more of a class then end, or NULL when the run is empty
+static inline const char *lex_run(const char *s, bool (*is)(char)) noexcept {
+    if (!is(*s)) {
+        return NULL;
+    }
+    while (is(*s)) {
+        s++;
+    }
+    return s;
+}
+
+// REG_UNSIGNED
+static bool lex_unsigned(const char *s) noexcept {
+    if (s[0] == '0') {
+        return s[1] == 0;
+    }
+    const char *end = lex_isnonzero(s[0]) ? lex_run(s, lex_isdigit) : NULL;
+    return end && *end == 0;
+}
+
+// REG_SIGNED
+static bool lex_signed(const char *s) noexcept {
+    return lex_issign(s[0]) && lex_unsigned(&s[1]);
+}
+
+// REG_HEX, REG_OCT and REG_BIN, '0', a letter then digits
+static bool lex_prefixed(const char *s, char letter, bool (*is)(char)) noexcept {
+    if (s[0] != '0' || (s[1] | 0x20) != letter) {
+        return false;
+    }
+    const char *end = lex_run(&s[2], is);
+    return end && *end == 0;
+}
+
+// REG_HEX_POST, REG_OCT_POST and REG_BIN_POST, digits then a letter
+static bool lex_postfixed(const char *s, char letter, bool (*is)(char)) noexcept {
+    const char *end = lex_run(s, is);
+    return end && (end[0] | 0x20) == letter && end[1] == 0;
+}
+
+// REG_OCT_PRE
+static bool lex_octal_pre(const char *s) noexcept {
+    if (s[0] != '0') {
+        return false;
+    }
+    const char *end = lex_run(&s[1], lex_isoct);
+    return end && *end == 0;
+}
+
+// [eE][+-]?[0-9]+ returning its end, or NULL
+static const char *lex_exponent(const char *s) noexcept {
+    if ((s[0] | 0x20) != 'e') {
+        return NULL;
+    }
+    s++;
+    if (lex_issign(*s)) {
+        s++;
+    }
+    return lex_run(s, lex_isdigit);
+}
+
+// an optional exponent then end
+static bool lex_exponent_end(const char *s) noexcept {
+    if (*s == 0) {
+        return true;
+    }
+    s = lex_exponent(s);
+    return s && *s == 0;
+}
+
+// the alternatives of REG_FLOAT after its leading optional sign
+static bool lex_float_body(const char *s) noexcept {
+    const char *p;
+
+    // 0?\.[0-9]+
+    p = s[0] == '0' ? &s[1] : s;
+    if (p[0] == '.' && (p = lex_run(&p[1], lex_isdigit)) && lex_exponent_end(p)) {
+        return true;
+    }
+
+    // [+-]?(0\.)([eE][+-]?[0-9]+)? with the trailing exponent too
+    p = lex_issign(s[0]) ? &s[1] : s;
+    if (p[0] == '0' && p[1] == '.') {
+        p = &p[2];
+        if (*p == 0) {
+            return true;
+        }
+        p = lex_exponent(p);
+        if (p && lex_exponent_end(p)) {
+            return true;
+        }
+    }
+
+    // [+-]?[1-9][0-9]*\.[0-9]*
+    p = lex_issign(s[0]) ? &s[1] : s;
+    if (lex_isnonzero(p[0])) {
+        p = lex_run(p, lex_isdigit);
+        if (p[0] == '.') {
+            p++;
+            while (lex_isdigit(*p)) {
+                p++;
+            }
+            if (lex_exponent_end(p)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// REG_FLOAT
+static bool lex_float(const char *s) noexcept {
+    if (lex_float_body(s) || (lex_issign(s[0]) && lex_float_body(&s[1]))) {
+        return true;
+    }
+
+    // [+-]?[1-9][0-9]*([eE][+-]?[0-9]+)
+    const char *p = lex_issign(s[0]) ? &s[1] : s;
+    if (!lex_isnonzero(p[0])) {
+        return false;
+    }
+    p = lex_exponent(lex_run(p, lex_isdigit));
+    return p && *p == 0;
+}
+
+static bool lex_hexadecimal(const char *s) noexcept { return lex_prefixed(s, 'x', lex_ishex); }
+static bool lex_hexadecimal_post(const char *s) noexcept { return lex_postfixed(s, 'h', lex_ishex); }
+static bool lex_octal(const char *s) noexcept { return lex_prefixed(s, 'o', lex_isoct); }
+static bool lex_octal_post(const char *s) noexcept { return lex_postfixed(s, 'o', lex_isoct); }
+static bool lex_binary(const char *s) noexcept { return lex_prefixed(s, 'b', lex_isbin); }
+static bool lex_binary_post(const char *s) noexcept { return lex_postfixed(s, 'b', lex_isbin); }
+
+/**
+ * Names of the engine, the same for every width so kept once here
+ */
+
+// order of precedence, lowest to highest, but for big which ranks between
+// uint and float and is last to keep the codes of images and stores
+enum Type {
+    TYPE_INT,
+    TYPE_UINT,
+    TYPE_FLOAT,
+    TYPE_STRING,
+    TYPE_BIG,
+    TYPE_COUNT
+};
+
+static const char *typeTable[] = {
+    "int",
+    "uint",
+    "float",
+    "string",
+    "bigint", // "big" is the format
+    "",
+};
+
+enum Format {
+    FORMAT_DEC,
+    FORMAT_HEX,
+    FORMAT_OCT,
+    FORMAT_BIN,
+    FORMAT_BIG,
+    FORMAT_LITTLE,
+    FORMAT_CHAR,
+    FORMAT_TYPE,
+    FORMAT_LANES8,
+    FORMAT_LANES16,
+    FORMAT_LANES32,
+    FORMAT_COUNT
+};
+
+static const char *formatTable[] = {
+    "dec",
+    "hex",
+    "oct",
+    "bin",
+    "big", // endianness
+    "little",
+    "chr",
+    "type",
+    "lanes8", // of a vector register, lane 0 first
+    "lanes16",
+    "lanes32",
+    "",
+};
+
+// the flags word of addf, subf, mulf and shlf, NZCV in the order of ARM's
+enum Flag {
+    FLAG_V = 1 << 0, // signed overflow
+    FLAG_C = 1 << 1, // carry out, the borrow of sub
+    FLAG_Z = 1 << 2,
+    FLAG_N = 1 << 3, // the top bit of the result
+};
+
+#define OP_NAME(Name, Op) Name,
+static const char *opNames[] = {
+    RPN_OPERATIONS(OP_NAME)
+    NULL,
+};
+#undef OP_NAME
+
+// the value of each is constant_of() of the width
+static const char *constantTable[] = {
+    "pi",
+    "%e",
+    "inf",
+    "-inf",
+    "nan",
+    "true",
+    "false",
+    "intmax",
+    "uintmax",
+    "floatmax",
+    "floatmin",
+    "bitmax",
+    "fmantmask",
+    "fexpmask",
+    "fexpbit",
+    NULL,
+};
+
+// index into opNames by name, built on first use
+static int op_find(const char *name) noexcept {
+    struct Table {
+        short slot[512]; // opNames index + 1, 0 when empty
+
+        static unsigned hash(const char *s) noexcept {
+            unsigned h = 2166136261u;
+            for (; *s; s++) {
+                h = (h ^ (unsigned char)*s) * 16777619u;
+            }
+            return h;
+        }
+
+        Table() noexcept : slot{} {
+            for (int i = 0; opNames[i] != NULL; i++) {
+                unsigned h = hash(opNames[i]);
+                for (;; h++) {
+                    short& s = slot[h % 512];
+                    if (s == 0) {
+                        s = (short)(i + 1);
+                        break;
+                    }
+                    if (strcmp(opNames[s - 1], opNames[i]) == 0) {
+                        break; // first entry of a name wins
+                    }
+                }
+            }
+        }
+    };
+    static const Table table;
+
+    for (unsigned h = Table::hash(name);; h++) {
+        short s = table.slot[h % 512];
+        if (s == 0) {
+            return -1;
+        }
+        if (strcmp(opNames[s - 1], name) == 0) {
+            return s - 1;
+        }
+    }
+}
+
+static size_t op_count() noexcept {
+    size_t i = 0;
+    while (opNames[i] != NULL) {
+        i++;
+    }
+    return i;
+}
+
+// an image records operations by index, it is only valid for the same names
+static uint32_t op_fingerprint() noexcept {
+    uint32_t h = 2166136261u;
+    for (int i = 0; opNames[i] != NULL; i++) {
+        for (const char *s = opNames[i]; ; s++) {
+            h = (h ^ (unsigned char)*s) * 16777619u;
+            if (*s == 0) {
+                break;
+            }
+        }
+    }
+    return h;
+}
+
+static void help_print() noexcept {
+    size_t len;
+    printf("Operations can be binary or unary, following C-style convention\n");
+    printf("Special operations are 'end' or 'sep' which print a newline or space\n");
+    printf("Macros are defined by '" REG_OP_DEF " NAME ... " REG_OP_ENDDEF "' and inlined wherever NAME is used\n");
+
+    printf("Format is space-seperated RPN (Reverse Polish Notation)\n\n\t");
+    len = 0;
+    for (int i = 0; opNames[i] != NULL; i++) {
+        if (len > 60) {
+            printf("\n\t");
+            len = 0;
+        }
+        printf("%s ", opNames[i]);
+        len += strlen(opNames[i]) + 1;
+    }
+    printf("\n\n");
+
+    printf("Types can be used as the rhs operand of 'as' or 'cast' operations\n\n\t");
+    for (int i = 0; i < TYPE_COUNT; i++) {
+        printf("%s ", typeTable[i]);
+    }
+    printf("\n\n");
+
+    printf("Formats must be the rhs operand of 'as' operations\n\n\t");
+    for (int i = 0; i < FORMAT_COUNT; i++) {
+        printf("%s ", formatTable[i]);
+    }
+    printf("\n\n");
+
+    printf("Constants consist of\n\n\t");
+    len = 0;
+    for (size_t i = 0; constantTable[i] != NULL; i++) {
+        if (len > 60) {
+            printf("\n\t");
+            len = 0;
+        }
+        printf("%s ", constantTable[i]);
+        len += strlen(constantTable[i]) + 1;
+    }
+    printf("\n");
+
+    fflush(stdout);
+}
+
+/**
+ * Compiled images, the checks that don't depend on the width
+ */
+
+// why the image can't be run, NULL when its layout is sound
+static const char *image_check(const void *data, size_t size) noexcept {
+    const ImageHeader *header = (const ImageHeader *)data;
+    if (size < sizeof(ImageHeader) || memcmp(header->magic, IMAGE_MAGIC, 4) != 0) {
+        return "not a compiled program";
+    }
+    if (header->order != IMAGE_ORDER) {
+        return "compiled on a machine of another byte order";
+    }
+    if (header->version != IMAGE_VERSION) {
+        return "compiled by another version of hd";
+    }
+
+    size_t body = size - sizeof(ImageHeader);
+    if (header->count > body / sizeof(ImageInsn) ||
+        header->strings != body - header->count * sizeof(ImageInsn)) {
+        return "truncated or corrupt";
+    }
+    const char *strings = (const char *)data + size - header->strings;
+    if (header->strings > 0 && strings[header->strings - 1] != 0) {
+        return "corrupt string table";
+    }
+    return NULL;
 }
 
 /**
@@ -114,3 +444,11 @@ namespace Rpn64 {
     #include "rpn.cc"
     #undef RPN_64BITS
 }
+
+#ifdef HD_QUAD
+namespace Rpn128 {
+    #define RPN_128BITS
+    #include "rpn.cc"
+    #undef RPN_128BITS
+}
+#endif
@@ -0,0 +1,511 @@
+#include <new>
+#include <string>
+#include <vector>
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "big.hpp"
+#include "cpu.hpp"
+#include "rpn.hpp"
+#include "wide.hpp"
+
+/**
+ * The engine of 'hd --wide N', numbers are bit vectors of N bits, up to
+ * 4096, for masks too wide for a word: CPU feature bitmaps, vector
+ * registers, bloom filter words. It has the bitwise operators, shifts,
+ * rotates and bit counts of the word engines, literals are binary, octal,
+ * hex or decimal and wrap past N. Vectors print in hex, counts in decimal,
+ * either as any other format by 'as'.
+ */
+
+#define EPRINT(...) \
+do { \
+    if (_verbose) { \
+        fprintf(rpn_stderr(), __VA_ARGS__); \
+    } \
+} while (0)
+
+// the kernels for the CPU, picked once at startup
+static WideKernels wide_select() noexcept {
+    WideKernels kernels = wide_kernels(cpu_features());
+    cpu_select("wide ops", kernels.name);
+    return kernels;
+}
+
+static const WideKernels wide_kernels_best = wide_select();
+
+namespace RpnWide {
+
+enum Format {
+    FORMAT_HEX,
+    FORMAT_DEC,
+    FORMAT_OCT,
+    FORMAT_BIN,
+    FORMAT_COUNT
+};
+
+static const char *formatTable[] = {
+    "hex",
+    "dec",
+    "oct",
+    "bin",
+    "",
+};
+
+struct Number {
+    Format fmt;
+    uint64_t w[WIDE_MAX_WORDS]; // least significant first, the words of N
+};
+
+struct Rpn {
+    std::vector<std::string> tokens;
+    std::vector<Number> stack;
+};
+
+// of _wide, the vectors of this run
+static unsigned bits;
+static size_t words;
+
+static void width_set() noexcept {
+    bits = _wide ? _wide : 64;
+    words = (bits + 63) / 64;
+}
+
+// clears the bits of the top word past N
+static void number_trim(Number& n) noexcept {
+    if (bits % 64) {
+        n.w[words - 1] &= ((uint64_t)1 << (bits % 64)) - 1;
+    }
+}
+
+static Number number_of(uint64_t value, Format fmt) noexcept {
+    Number n;
+    n.fmt = fmt;
+    memset(n.w, 0, sizeof(n.w));
+    n.w[0] = value;
+    number_trim(n);
+    return n;
+}
+
+// n * mul + add, wrapping past N
+static void number_muladd(Number& n, unsigned mul, unsigned add) noexcept {
+    uint64_t carry = add;
+    for (size_t i = 0; i < words; i++) {
+        unsigned __int128 t = (unsigned __int128)n.w[i] * mul + carry;
+        n.w[i] = (uint64_t)t;
+        carry = (uint64_t)(t >> 64);
+    }
+}
+
+static unsigned digit_of(char c) noexcept {
+    if ('0' <= c && c <= '9') return (unsigned)(c - '0');
+    if ('a' <= c && c <= 'f') return (unsigned)(c - 'a' + 10);
+    if ('A' <= c && c <= 'F') return (unsigned)(c - 'A' + 10);
+    return 16;
+}
+
+// 0x, 0o and 0b prefixes, h, o and b suffixes or decimal, false for a word
+static bool literal_parse(const char *text, Number *out) noexcept {
+    size_t len = strlen(text);
+    unsigned base = 10;
+    if (len > 2 && text[0] == '0' && strchr("xXoObB", text[1])) {
+        base = (text[1] | 0x20) == 'x' ? 16 : (text[1] | 0x20) == 'o' ? 8 : 2;
+        text += 2;
+        len -= 2;
+    }
+    else if (len > 1 && strchr("hHoO", text[len - 1])) {
+        base = (text[len - 1] | 0x20) == 'h' ? 16 : 8;
+        len--;
+    }
+    else if (len > 1 && strchr("bB", text[len - 1]) && strspn(text, "01") == len - 1) {
+        base = 2;
+        len--;
+    }
+    if (len == 0) {
+        return false;
+    }
+    *out = number_of(0, FORMAT_HEX);
+    for (size_t i = 0; i < len; i++) {
+        unsigned d = digit_of(text[i]);
+        if (d >= base) {
+            return false;
+        }
+        number_muladd(*out, base, d);
+    }
+    number_trim(*out);
+    return true;
+}
+
+/**
+ * Operations
+ */
+
+static unsigned count_leading(const Number& n) noexcept {
+    for (size_t i = words; i-- > 0;) {
+        if (n.w[i]) {
+            return bits - 1 - (unsigned)(i * 64 + 63 - (size_t)__builtin_clzll(n.w[i]));
+        }
+    }
+    return bits;
+}
+
+static unsigned count_trailing(const Number& n) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        if (n.w[i]) {
+            return (unsigned)(i * 64 + (size_t)__builtin_ctzll(n.w[i]));
+        }
+    }
+    return bits;
+}
+
+// a shift count, N for any at least as large
+static unsigned count_of(const Number& n) noexcept {
+    for (size_t i = 1; i < words; i++) {
+        if (n.w[i]) {
+            return bits;
+        }
+    }
+    return n.w[0] < bits ? (unsigned)n.w[0] : bits;
+}
+
+// a rotate count, n modulo N word by word from the top
+static unsigned rotation_of(const Number& n) noexcept {
+    uint64_t scale = (UINT64_MAX % bits + 1) % bits; // 2^64 mod N
+    uint64_t r = 0;
+    for (size_t i = words; i-- > 0;) {
+        r = (r * scale + n.w[i] % bits) % bits;
+    }
+    return (unsigned)r;
+}
+
+static Number shift_left(const Number& a, unsigned k) noexcept {
+    Number out = number_of(0, a.fmt);
+    size_t q = k / 64;
+    unsigned r = k % 64;
+    for (size_t i = q; i < words; i++) {
+        out.w[i] = a.w[i - q] << r;
+        if (r && i > q) {
+            out.w[i] |= a.w[i - q - 1] >> (64 - r);
+        }
+    }
+    number_trim(out);
+    return out;
+}
+
+static Number shift_right(const Number& a, unsigned k) noexcept {
+    Number out = number_of(0, a.fmt);
+    size_t q = k / 64;
+    unsigned r = k % 64;
+    for (size_t i = 0; i + q < words; i++) {
+        out.w[i] = a.w[i + q] >> r;
+        if (r && i + q + 1 < words) {
+            out.w[i] |= a.w[i + q + 1] << (64 - r);
+        }
+    }
+    return out;
+}
+
+static Number rotate_left(const Number& a, unsigned k) noexcept {
+    if (k == 0) {
+        return a;
+    }
+    Number out = shift_left(a, k);
+    Number low = shift_right(a, bits - k);
+    wide_kernels_best.bit_or(out.w, out.w, low.w, words);
+    return out;
+}
+
+enum Op {
+    OP_AND,
+    OP_OR,
+    OP_XOR,
+    OP_CLEAR,
+    OP_SHL,
+    OP_SHR,
+    OP_ROL,
+    OP_ROR,
+    OP_INV,
+    OP_SETBITS,
+    OP_CLEARBITS,
+    OP_CLZ,
+    OP_CTZ,
+    OP_PARITY,
+    OP_END,
+    OP_SEP,
+    OP_QUIET,
+    OP_AS,
+};
+
+#define BINARY_OPS OP_INV // those before take two operands
+
+static const struct {
+    const char *name;
+    Op op;
+} opLookup[] = {
+    {REG_OP_BITAND_SYM, OP_AND},
+    {REG_OP_BITAND, OP_AND},
+    {REG_OP_BITOR_SYM, OP_OR},
+    {REG_OP_BITOR, OP_OR},
+    {REG_OP_BITXOR_SYM, OP_XOR},
+    {REG_OP_BITXOR, OP_XOR},
+    {REG_OP_BITCLEAR_SYM, OP_CLEAR},
+    {REG_OP_BITCLEAR, OP_CLEAR},
+    {REG_OP_SHL_SYM, OP_SHL},
+    {REG_OP_SHL, OP_SHL},
+    {REG_OP_LSH, OP_SHL},
+    {REG_OP_SHR_SYM, OP_SHR},
+    {REG_OP_SHR, OP_SHR},
+    {REG_OP_RSH, OP_SHR},
+    {REG_OP_ROL, OP_ROL},
+    {REG_OP_ROR, OP_ROR},
+    {REG_OP_INV_SYM, OP_INV},
+    {REG_OP_INV, OP_INV},
+    {REG_OP_SETBITS, OP_SETBITS},
+    {REG_OP_CLEARBITS, OP_CLEARBITS},
+    {REG_OP_CLZ, OP_CLZ},
+    {REG_OP_CTZ, OP_CTZ},
+    {REG_OP_PARITY, OP_PARITY},
+    {REG_OP_END_SYM, OP_END},
+    {REG_OP_END, OP_END},
+    {REG_OP_SEP_SYM, OP_SEP},
+    {REG_OP_SEP, OP_SEP},
+    {REG_OP_QUIET, OP_QUIET},
+    {REG_OP_AS, OP_AS},
+    {NULL, OP_AND},
+};
+
+static int op_find(const char *name) noexcept {
+    for (int i = 0; opLookup[i].name != NULL; i++) {
+        if (strcmp(opLookup[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int format_find(const char *name) noexcept {
+    for (int i = 0; i < FORMAT_COUNT; i++) {
+        if (strcmp(formatTable[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Printing
+ */
+
+// len bits from pos on, 0 past the vector
+static unsigned bits_at(const Number& n, unsigned pos, unsigned len) noexcept {
+    size_t i = pos / 64;
+    unsigned r = pos % 64;
+    uint64_t v = n.w[i] >> r;
+    if (r + len > 64 && i + 1 < words) {
+        v |= n.w[i + 1] << (64 - r);
+    }
+    return (unsigned)(v & ((1u << len) - 1));
+}
+
+static void number_print(const Number& n, const char *end) noexcept {
+    FILE *out = rpn_stdout();
+    if (n.fmt == FORMAT_DEC) {
+        Big big;
+        big.neg = false;
+        big.mag.assign(n.w, n.w + words);
+        while (!big.mag.empty() && big.mag.back() == 0) {
+            big.mag.pop_back();
+        }
+        fprintf(out, "%s%s", big_to_string(&big, 10).c_str(), end);
+        fflush(out);
+        return;
+    }
+
+    unsigned shift = n.fmt == FORMAT_HEX ? 4 : n.fmt == FORMAT_OCT ? 3 : 1;
+    unsigned digits = (bits + shift - 1) / shift;
+    char text[WIDE_MAX_BITS + 1];
+    size_t len = 0;
+    for (unsigned d = digits; d-- > 0;) {
+        unsigned v = bits_at(n, d * shift, shift);
+        if (len || v || _longform || d == 0) {
+            text[len++] = "0123456789ABCDEF"[v];
+        }
+    }
+    text[len] = 0;
+    fprintf(out, "%s%s%s", n.fmt == FORMAT_HEX ? "0x" : n.fmt == FORMAT_OCT ? "0o" : "0b", text, end);
+    fflush(out);
+}
+
+/**
+ * Evaluation
+ */
+
+static Number pop(Rpn *self, const char *op) noexcept {
+    if (self->stack.empty()) {
+        EPRINT("%s: Stack empty\n", op);
+        rpn_exit(1);
+    }
+    Number n = self->stack.back();
+    self->stack.pop_back();
+    return n;
+}
+
+static void apply(Rpn *self, Op op, const char *name) noexcept {
+    Number rhs = {};
+    if (op < BINARY_OPS) {
+        rhs = pop(self, name);
+    }
+    Number lhs = pop(self, name);
+    Number res = lhs;
+
+    switch (op) {
+    case OP_AND: wide_kernels_best.bit_and(res.w, lhs.w, rhs.w, words); break;
+    case OP_OR: wide_kernels_best.bit_or(res.w, lhs.w, rhs.w, words); break;
+    case OP_XOR: wide_kernels_best.bit_xor(res.w, lhs.w, rhs.w, words); break;
+    case OP_CLEAR: wide_kernels_best.bit_clear(res.w, lhs.w, rhs.w, words); break;
+    case OP_SHL: res = shift_left(lhs, count_of(rhs)); break;
+    case OP_SHR: res = shift_right(lhs, count_of(rhs)); break;
+    case OP_ROL: res = rotate_left(lhs, rotation_of(rhs)); break;
+    case OP_ROR: res = rotate_left(lhs, (bits - rotation_of(rhs)) % bits); break;
+    case OP_INV:
+        wide_kernels_best.inv(res.w, lhs.w, words);
+        number_trim(res);
+        break;
+    case OP_SETBITS:
+        res = number_of(wide_kernels_best.popcount(lhs.w, words), FORMAT_DEC);
+        break;
+    case OP_CLEARBITS:
+        res = number_of(bits - wide_kernels_best.popcount(lhs.w, words), FORMAT_DEC);
+        break;
+    case OP_CLZ: res = number_of(count_leading(lhs), FORMAT_DEC); break;
+    case OP_CTZ: res = number_of(count_trailing(lhs), FORMAT_DEC); break;
+    case OP_PARITY: res = number_of(wide_kernels_best.popcount(lhs.w, words) & 1, FORMAT_DEC); break;
+    case OP_END: number_print(lhs, "\n"); return;
+    case OP_SEP: number_print(lhs, " "); return;
+    case OP_QUIET: return;
+    case OP_AS: break; // taken with its format by rpn_exec
+    }
+    self->stack.push_back(res);
+}
+
+Rpn *rpn_create() noexcept {
+    width_set();
+    Rpn *self = new (std::nothrow) Rpn();
+    if (!self) {
+        EPRINT("create: Out of memory\n");
+        rpn_exit(1);
+    }
+    return self;
+}
+
+void rpn_exec(Rpn *self) noexcept {
+    assert(self);
+    width_set();
+    const std::vector<std::string>& tokens = self->tokens;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const char *text = tokens[i].c_str();
+        Number n;
+        if (literal_parse(text, &n)) {
+            self->stack.push_back(n);
+            continue;
+        }
+        int fmt = format_find(text);
+        if (fmt >= 0) {
+            if (i + 1 == tokens.size() || tokens[i + 1] != REG_OP_AS) {
+                EPRINT("%s: Missing '" REG_OP_AS "'\n", text);
+                rpn_exit(1);
+            }
+            if (self->stack.empty()) {
+                EPRINT(REG_OP_AS ": Stack empty\n");
+                rpn_exit(1);
+            }
+            self->stack.back().fmt = (Format)fmt;
+            i++;
+            continue;
+        }
+        int op = op_find(text);
+        if (op < 0 || opLookup[op].op == OP_AS) {
+            EPRINT("operation: '%s' does not exist with --wide\n", text);
+            rpn_exit(1);
+        }
+        apply(self, opLookup[op].op, text);
+    }
+    self->tokens.clear();
+}
+
+void rpn_push(Rpn *self, char *value) noexcept {
+    assert(self);
+    self->tokens.push_back(value);
+}
+
+void rpn_push_token(Rpn *self, const char *token, size_t len) noexcept {
+    assert(self);
+    self->tokens.emplace_back(token, len);
+}
+
+void rpn_print(Rpn *self) noexcept {
+    assert(self);
+    if (self->stack.empty()) {
+        EPRINT("print: Stack empty\n");
+        rpn_exit(1);
+    }
+    number_print(self->stack.back(), "\n");
+}
+
+void rpn_destroy(Rpn *self) noexcept {
+    assert(self);
+    delete self;
+}
+
+void rpn_help() noexcept {
+    printf("Numbers of --wide are bit vectors of its width, up to %u bits\n\n\t", WIDE_MAX_BITS);
+    for (int i = 0; opLookup[i].name != NULL; i++) {
+        printf("%s ", opLookup[i].name);
+    }
+    printf("\n\nFormats are the rhs operand of 'as'\n\n\t");
+    for (int i = 0; i < FORMAT_COUNT; i++) {
+        printf("%s ", formatTable[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+void rpn_reset(Rpn *self) noexcept {
+    assert(self);
+    self->tokens.clear();
+    self->stack.clear();
+}
+
+bool rpn_convert(char *value) noexcept {
+    (void)value;
+    return false;
+}
+
+bool rpn_save(Rpn *self, FILE *file) noexcept {
+    (void)self;
+    (void)file;
+    errno = ENOTSUP; // images hold words, not vectors
+    return false;
+}
+
+bool rpn_load(Rpn *self, const void *data, size_t size) noexcept {
+    (void)self;
+    (void)data;
+    (void)size;
+    EPRINT("image: not supported with --wide\n");
+    return false;
+}
+
+void rpn_map(Rpn *self, const void *data, size_t size, bool big_endian) noexcept {
+    (void)self;
+    (void)data;
+    (void)size;
+    (void)big_endian;
+    EPRINT("words: not supported with --wide\n");
+    rpn_exit(1);
+}
+
+}
@@ -0,0 +1,494 @@
+#include <stdio.h>
+
+#include "serve.hpp"
+
+#if defined(__linux__)
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+struct Conn {
+    int fd;
+    bool busy; // a request is with the workers, the next waits for it
+    bool closed; // peer is gone, freed once the workers are done with it
+    bool eof; // peer finished sending, answer what arrived then close
+    uint32_t events;
+    std::vector<char> in;
+    size_t inpos;
+    std::vector<char> out;
+    size_t outpos;
+};
+
+struct Job {
+    Conn *conn;
+    std::vector<char> program; // NUL terminated
+    std::vector<char> response;
+};
+
+struct Server {
+    RpnVtable *rpn;
+    int epfd;
+    int wakefd; // eventfd, workers signal finished jobs
+    bool stopping;
+
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<Job *> pending;
+
+    std::mutex donelock;
+    std::deque<Job *> done;
+};
+
+// epoll tags for the descriptors which are not connections
+static char tag_listen;
+static char tag_wake;
+static char tag_signal;
+
+static void put_u32(std::vector<char>& buf, size_t at, uint32_t value) noexcept {
+    value = htonl(value);
+    memcpy(&buf[at], &value, sizeof(value));
+}
+
+static uint32_t get_u32(const char *buf) noexcept {
+    uint32_t value;
+    memcpy(&value, buf, sizeof(value));
+    return ntohl(value);
+}
+
+static void run(RpnVtable *rpn, void *calc, char *program) noexcept {
+    char *save = NULL;
+    for (char *tok = strtok_r(program, " \t\r\n", &save); tok; tok = strtok_r(NULL, " \t\r\n", &save)) {
+        rpn->push(calc, tok);
+    }
+    rpn->exec(calc);
+    rpn->print(calc);
+}
+
+// no locals live across the setjmp, the engine longjmps here on error
+static int evaluate(RpnVtable *rpn, void *calc, char *program, FILE *out, FILE *err) noexcept {
+    jmp_buf trap;
+    int status = setjmp(trap);
+    if (status == 0) {
+        _rpnout = out;
+        _rpnerr = err;
+        _rpntrap = &trap;
+        run(rpn, calc, program);
+    }
+    _rpntrap = NULL;
+    _rpnout = NULL;
+    _rpnerr = NULL;
+    return status;
+}
+
+static void worker_main(Server *server) noexcept {
+    char *outbuf = NULL, *errbuf = NULL;
+    size_t outlen = 0, errlen = 0;
+    FILE *out = open_memstream(&outbuf, &outlen);
+    FILE *err = open_memstream(&errbuf, &errlen);
+    if (!out || !err) {
+        fprintf(stderr, "serve: out of memory\n");
+        exit(ENOMEM);
+    }
+
+    // warm context, reset between programs instead of rebuilt
+    void *calc = server->rpn->create();
+
+    for (;;) {
+        Job *job;
+        {
+            std::unique_lock<std::mutex> guard(server->lock);
+            server->ready.wait(guard, [server] {
+                return server->stopping || !server->pending.empty();
+            });
+            if (server->pending.empty()) {
+                break;
+            }
+            job = server->pending.front();
+            server->pending.pop_front();
+        }
+
+        rewind(out);
+        rewind(err);
+        int status = evaluate(server->rpn, calc, job->program.data(), out, err);
+        server->rpn->reset(calc);
+        fflush(out);
+        fflush(err);
+
+        const char *body = status ? errbuf : outbuf;
+        size_t len = status ? errlen : outlen;
+        job->response.resize(2 * sizeof(uint32_t) + len);
+        put_u32(job->response, 0, (uint32_t)len);
+        put_u32(job->response, sizeof(uint32_t), (uint32_t)status);
+        if (len) {
+            memcpy(&job->response[2 * sizeof(uint32_t)], body, len);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(server->donelock);
+            server->done.push_back(job);
+        }
+        uint64_t one = 1;
+        if (write(server->wakefd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            perror("serve: eventfd");
+        }
+    }
+
+    server->rpn->destroy(calc);
+    fclose(out);
+    fclose(err);
+    free(outbuf);
+    free(errbuf);
+}
+
+static void conn_update(Server *server, Conn *conn) noexcept {
+    uint32_t events = 0;
+    // stop reading once a full frame is waiting behind a busy request
+    if (!conn->eof && conn->in.size() - conn->inpos < SERVE_MAX_FRAME + sizeof(uint32_t)) {
+        events |= EPOLLIN;
+    }
+    if (conn->outpos < conn->out.size()) {
+        events |= EPOLLOUT;
+    }
+    if (events != conn->events) {
+        struct epoll_event ev;
+        ev.events = events;
+        ev.data.ptr = conn;
+        epoll_ctl(server->epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+        conn->events = events;
+    }
+}
+
+static void conn_close(Server *server, Conn *conn) noexcept {
+    epoll_ctl(server->epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->fd = -1;
+    conn->closed = true;
+    if (!conn->busy) {
+        delete conn;
+    }
+}
+
+// returns false when the connection was closed
+static bool conn_dispatch(Server *server, Conn *conn) noexcept {
+    size_t avail = conn->in.size() - conn->inpos;
+    if (conn->busy || avail < sizeof(uint32_t)) {
+        return true;
+    }
+
+    uint32_t len = get_u32(&conn->in[conn->inpos]);
+    if (len > SERVE_MAX_FRAME) {
+        fprintf(stderr, "serve: %u byte request exceeds %u\n", len, SERVE_MAX_FRAME);
+        conn_close(server, conn);
+        return false;
+    }
+    if (avail < sizeof(uint32_t) + len) {
+        return true;
+    }
+
+    Job *job = new (std::nothrow) Job{};
+    if (!job) {
+        fprintf(stderr, "serve: out of memory\n");
+        exit(ENOMEM);
+    }
+    const char *program = &conn->in[conn->inpos + sizeof(uint32_t)];
+    job->conn = conn;
+    job->program.assign(program, program + len);
+    job->program.push_back(0);
+    conn->inpos += sizeof(uint32_t) + len;
+    if (conn->inpos == conn->in.size()) {
+        conn->in.clear();
+        conn->inpos = 0;
+    }
+
+    conn->busy = true;
+    {
+        std::lock_guard<std::mutex> guard(server->lock);
+        server->pending.push_back(job);
+    }
+    server->ready.notify_one();
+    return true;
+}
+
+// dispatch the next request and close once a finished peer is answered,
+// returns false when the connection was closed
+static bool conn_settle(Server *server, Conn *conn) noexcept {
+    if (!conn_dispatch(server, conn)) {
+        return false;
+    }
+    if (conn->eof && !conn->busy && conn->out.empty()) {
+        conn_close(server, conn);
+        return false;
+    }
+    conn_update(server, conn);
+    return true;
+}
+
+static bool conn_flush(Server *server, Conn *conn) noexcept {
+    while (conn->outpos < conn->out.size()) {
+        ssize_t n = write(conn->fd, &conn->out[conn->outpos], conn->out.size() - conn->outpos);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            conn_close(server, conn);
+            return false;
+        }
+        conn->outpos += (size_t)n;
+    }
+    if (conn->outpos == conn->out.size()) {
+        conn->out.clear();
+        conn->outpos = 0;
+    }
+    return true;
+}
+
+// returns false when the connection was closed
+static bool conn_read(Server *server, Conn *conn) noexcept {
+    char buf[64 * 1024];
+    for (;;) {
+        ssize_t n = read(conn->fd, buf, sizeof(buf));
+        if (n > 0) {
+            conn->in.insert(conn->in.end(), buf, buf + n);
+            if (conn->in.size() - conn->inpos >= SERVE_MAX_FRAME + sizeof(uint32_t)) {
+                break;
+            }
+            continue;
+        }
+        if (n == 0) {
+            conn->eof = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        conn_close(server, conn);
+        return false;
+    }
+
+    return conn_settle(server, conn);
+}
+
+static void on_accept(Server *server, int lfd) noexcept {
+    for (;;) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("serve: accept");
+            }
+            return;
+        }
+
+        Conn *conn = new (std::nothrow) Conn{};
+        if (!conn) {
+            fprintf(stderr, "serve: out of memory\n");
+            exit(ENOMEM);
+        }
+        conn->fd = fd;
+        conn->events = EPOLLIN;
+
+        struct epoll_event ev;
+        ev.events = conn->events;
+        ev.data.ptr = conn;
+        if (epoll_ctl(server->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            perror("serve: epoll_ctl");
+            close(fd);
+            delete conn;
+        }
+    }
+}
+
+static void on_done(Server *server) noexcept {
+    uint64_t count;
+    if (read(server->wakefd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        perror("serve: eventfd");
+    }
+
+    std::deque<Job *> done;
+    {
+        std::lock_guard<std::mutex> guard(server->donelock);
+        done.swap(server->done);
+    }
+
+    for (Job *job : done) {
+        Conn *conn = job->conn;
+        conn->busy = false;
+        if (conn->closed) {
+            delete conn;
+            delete job;
+            continue;
+        }
+
+        conn->out.insert(conn->out.end(), job->response.begin(), job->response.end());
+        delete job;
+        if (conn_flush(server, conn)) {
+            conn_settle(server, conn);
+        }
+    }
+}
+
+static int listen_on(const char *path) noexcept {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "serve: '%s' is too long for a socket path\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // replace a stale socket left by a previous daemon, but nothing else
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("serve: socket");
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "serve: %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool watch(int epfd, int fd, void *tag) noexcept {
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = tag;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("serve: epoll_ctl");
+        return false;
+    }
+    return true;
+}
+
+int serve_main(const char *path, RpnVtable *rpn, int workers) noexcept {
+    if (workers <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (int)cpus : 1;
+    }
+
+    // workers inherit the mask, only the event loop sees these via signalfd
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    Server server;
+    server.rpn = rpn;
+    server.stopping = false;
+
+    int lfd = listen_on(path);
+    if (lfd < 0) {
+        return 1;
+    }
+    int sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    server.wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    server.epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (sfd < 0 || server.wakefd < 0 || server.epfd < 0) {
+        perror("serve");
+        return 1;
+    }
+    if (!watch(server.epfd, lfd, &tag_listen) ||
+        !watch(server.epfd, server.wakefd, &tag_wake) ||
+        !watch(server.epfd, sfd, &tag_signal)) {
+        return 1;
+    }
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < workers; i++) {
+        pool.emplace_back(worker_main, &server);
+    }
+    if (_verbose) fprintf(stderr, "serve: listening on %s with %d workers\n", path, workers);
+
+    struct epoll_event events[64];
+    while (!server.stopping) {
+        int n = epoll_wait(server.epfd, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("serve: epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            void *tag = events[i].data.ptr;
+            if (tag == &tag_listen) {
+                on_accept(&server, lfd);
+            }
+            else if (tag == &tag_wake) {
+                on_done(&server);
+            }
+            else if (tag == &tag_signal) {
+                server.stopping = true;
+            }
+            else {
+                Conn *conn = (Conn *)tag;
+                bool open = true;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    open = conn_read(&server, conn);
+                }
+                if (open && (events[i].events & EPOLLOUT) && conn_flush(&server, conn)) {
+                    conn_settle(&server, conn);
+                }
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(server.lock);
+        server.stopping = true;
+    }
+    server.ready.notify_all();
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    close(lfd);
+    unlink(path);
+    close(sfd);
+    close(server.wakefd);
+    close(server.epfd);
+    if (_verbose) fprintf(stderr, "serve: stopped\n");
+    return 0;
+}
+
+#else
+
+int serve_main(const char *path, RpnVtable *rpn, int workers) noexcept {
+    (void)path;
+    (void)rpn;
+    (void)workers;
+    fprintf(stderr, "serve: only supported on Linux\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef HD_SERVE_H
+#define HD_SERVE_H
+
+#include <stdint.h>
+
+#include "rpn.hpp"
+
+/**
+ * Daemon wire format, every integer is a big endian uint32_t
+ *
+ * request:  length, program
+ * response: length, status, output
+ *
+ * The program is the same whitespace seperated tokens given to 'hd' on the
+ * command line. A status of 0 means output holds what 'hd PROGRAM' prints,
+ * otherwise status is the exit code 'hd' would have returned and output holds
+ * the error message. Requests on one connection are answered in order.
+ */
+#define SERVE_MAX_FRAME (16u << 20)
+
+// blocks until SIGINT or SIGTERM, workers <= 0 picks one per online CPU
+int serve_main(const char *path, RpnVtable *rpn, int workers) noexcept;
+
+#endif // HD_SERVE_H
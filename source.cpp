@@ -0,0 +1,243 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu.hpp"
+#include "source.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#  define SOURCE_MMAP
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+// released in steps of this many bytes behind the scan
+#define SOURCE_RELEASE (1u << 20)
+
+static inline bool is_space(char c) noexcept {
+    return (unsigned char)c <= ' ';
+}
+
+// whitespace mask of 64 readable bytes
+typedef uint64_t (* SpaceMask)(const char *data);
+
+static uint64_t space_mask_scalar(const char *data) noexcept {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i++) {
+        if (is_space(data[i])) {
+            mask |= (uint64_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+#if defined(CPU_X86) && defined(__SSE2__)
+// unsigned v <= ' ' is min(v, ' ') == v
+static uint64_t space_mask_sse2(const char *data) noexcept {
+    const __m128i limit = _mm_set1_epi8(' ');
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)&data[16 * i]);
+        uint64_t bits = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, limit), v));
+        mask |= bits << (16 * i);
+    }
+    return mask;
+}
+#endif
+
+#ifdef CPU_X86
+__attribute__((target("avx2")))
+static uint64_t space_mask_avx2(const char *data) noexcept {
+    const __m256i limit = _mm256_set1_epi8(' ');
+    __m256i lo = _mm256_loadu_si256((const __m256i *)(const void *)data);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(const void *)&data[32]);
+    uint64_t low = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(lo, limit), lo));
+    uint64_t high = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(hi, limit), hi));
+    return low | (high << 32);
+}
+
+__attribute__((target("avx512bw")))
+static uint64_t space_mask_avx512(const char *data) noexcept {
+    __m512i v = _mm512_loadu_si512((const void *)data);
+    return _mm512_cmple_epu8_mask(v, _mm512_set1_epi8(' '));
+}
+#endif
+
+static SpaceMask space_select() noexcept {
+#ifdef CPU_X86
+    if (cpu_features() & CPU_AVX512BW) {
+        cpu_select("tokenizer", "avx512bw");
+        return space_mask_avx512;
+    }
+    if (cpu_features() & CPU_AVX2) {
+        cpu_select("tokenizer", "avx2");
+        return space_mask_avx2;
+    }
+#  ifdef __SSE2__
+    cpu_select("tokenizer", "sse2");
+    return space_mask_sse2;
+#  endif
+#endif
+    cpu_select("tokenizer", "scalar");
+    return space_mask_scalar;
+}
+
+static const SpaceMask space_block = space_select();
+
+// whitespace mask of the 64 bytes at block, bytes past the end count as space
+static uint64_t space_mask(const char *data, size_t block, size_t size) noexcept {
+    if (block + 64 <= size) {
+        return space_block(&data[block]);
+    }
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i++) {
+        if (block + i >= size || is_space(data[block + i])) {
+            mask |= (uint64_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * Appends the offsets where whitespace starts or stops within the next block
+ * to the edges, alternately a token start and end. Bytes before from are
+ * taken as whitespace. The positions are written eight at a time without
+ * branching on the count, the slack at the end of edges takes the overrun.
+ */
+static void source_index(Source *self, size_t from) noexcept {
+    if (self->head > 0) {
+        unsigned n = self->tail - self->head;
+        memmove(self->edges, &self->edges[self->head], n * sizeof(self->edges[0]));
+        self->head = 0;
+        self->tail = n;
+    }
+
+    size_t block = from & ~(size_t)63;
+    uint64_t space = space_mask(self->data, block, self->size);
+    if (from > block) {
+        space |= ~(uint64_t)0 >> (64 - (from - block));
+    }
+    uint64_t edges = space ^ ((space << 1) | self->carry);
+    self->carry = space >> 63;
+    self->block = block + 64;
+
+    size_t *out = &self->edges[self->tail];
+    unsigned count = (unsigned)__builtin_popcountll(edges);
+    for (unsigned i = 0; i < count; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            out[i + j] = block + (size_t)__builtin_ctzll(edges | ((uint64_t)1 << 63));
+            edges &= edges - 1;
+        }
+    }
+    self->tail += count;
+}
+
+bool source_open(Source *self, const char *path) noexcept {
+    memset(self, 0, sizeof(*self));
+    self->carry = 1;
+
+#ifdef SOURCE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return false;
+    }
+    self->size = (size_t)st.st_size;
+    if (self->size > 0) {
+        void *data = mmap(NULL, self->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, self->size, MADV_SEQUENTIAL);
+        self->data = (const char *)data;
+    }
+    close(fd);
+#else
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char *)malloc(size > 0 ? (size_t)size : 1);
+    if (size < 0 || !data || fread(data, 1, (size_t)size, file) != (size_t)size) {
+        free(data);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+    self->data = data;
+    self->size = (size_t)size;
+#endif
+    return true;
+}
+
+bool source_next(Source *self, const char **token, size_t *len) noexcept {
+    size_t start, end;
+    for (;;) {
+        while (self->tail - self->head < 2 && self->block < self->size) {
+            source_index(self, self->block);
+        }
+        if (self->tail == self->head) {
+            return false;
+        }
+        start = self->edges[self->head++];
+        // the end of a token running up to the end of the file is past the last block
+        end = self->head < self->tail ? self->edges[self->head++] : self->size;
+        if (self->data[start] != '#') {
+            break;
+        }
+        const char *eol = (const char *)memchr(&self->data[start], '\n', self->size - start);
+        if (!eol) {
+            self->head = self->tail;
+            self->block = self->size;
+            return false;
+        }
+        self->head = self->tail = 0;
+        self->carry = 1;
+        source_index(self, (size_t)(eol - self->data));
+    }
+
+    source_release(self, start);
+    *token = &self->data[start];
+    *len = end - start;
+    return true;
+}
+
+// gives back the pages before upto once a step of them has been read
+void source_release(Source *self, size_t upto) noexcept {
+#ifdef SOURCE_MMAP
+    if (upto - self->released >= SOURCE_RELEASE) {
+        upto &= ~(size_t)(sysconf(_SC_PAGESIZE) - 1);
+        madvise((void *)&self->data[self->released], upto - self->released, MADV_DONTNEED);
+        self->released = upto;
+    }
+#else
+    (void)self;
+    (void)upto;
+#endif
+}
+
+void source_close(Source *self) noexcept {
+#ifdef SOURCE_MMAP
+    if (self->data) {
+        munmap((void *)self->data, self->size);
+    }
+#else
+    free((void *)self->data);
+#endif
+    memset(self, 0, sizeof(*self));
+}
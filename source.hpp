@@ -0,0 +1,32 @@
+#ifndef HD_SOURCE_H
+#define HD_SOURCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Program text read from a file
+ *
+ * The file is mapped, not read, and tokenized in place. Tokens are seperated
+ * by whitespace and a token starting with '#' comments out the rest of its
+ * line. Pages already tokenized are released as the scan moves on, so memory
+ * stays bounded for files of any size; a token is only valid until the next
+ * call of source_next(). Files read as data rather than tokens release their
+ * pages with source_release().
+ */
+struct Source {
+    const char *data;
+    size_t size;
+    size_t released; // bytes at the start given back to the kernel
+    size_t block; // offset of the next 64 bytes to index
+    uint64_t carry; // 1 if the byte before block is whitespace
+    size_t edges[80]; // token starts and ends found, from head to tail
+    unsigned head, tail;
+};
+
+bool source_open(Source *self, const char *path) noexcept;
+bool source_next(Source *self, const char **token, size_t *len) noexcept;
+void source_release(Source *self, size_t upto) noexcept;
+void source_close(Source *self) noexcept;
+
+#endif // HD_SOURCE_H
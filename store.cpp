@@ -0,0 +1,214 @@
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+
+#include "store.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <mutex>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// flock() doesn't exclude threads sharing the descriptor
+static std::mutex store_mutex;
+
+// FNV-1a of the name without case, mixed with the word size
+static uint32_t store_hash(unsigned bits, const char *name) noexcept {
+    uint32_t h = 2166136261u ^ bits;
+    for (; *name; name++) {
+        h = (h ^ (unsigned char)tolower((unsigned char)*name)) * 16777619u;
+    }
+    return h;
+}
+
+// reads of a slot seen mid write before giving up, its writer died there
+// when it stays so, the next store_put() probing it mends it
+#define STORE_RETRIES (1 << 16)
+
+// a consistent copy of the slot, false for a slot never used and with errno
+// EBUSY for one stuck mid write
+static bool slot_read(const StoreSlot *slot, StoreSlot *out) noexcept {
+    for (unsigned tries = 0; tries < STORE_RETRIES; tries++) {
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq == 0) {
+            return false;
+        }
+        if (seq & 1) {
+            if (tries >= 64) {
+                sched_yield();
+            }
+            continue;
+        }
+        memcpy(out, slot, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq) {
+            out->name[STORE_NAME - 1] = 0;
+            return true;
+        }
+    }
+    errno = EBUSY;
+    return false;
+}
+
+static bool slot_match(const StoreSlot *slot, uint32_t hash, unsigned bits, const char *name) noexcept {
+    return slot->hash == hash && slot->bits == bits && strcasecmp(slot->name, name) == 0;
+}
+
+bool store_open(Store *self, const char *path) noexcept {
+    memset(self, 0, sizeof(*self));
+    self->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (self->fd < 0) {
+        return false;
+    }
+
+    // the first to lock an empty file lays it out
+    struct stat st;
+    if (flock(self->fd, LOCK_EX) < 0 || fstat(self->fd, &st) < 0) {
+        close(self->fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        StoreHeader header = {};
+        memcpy(header.magic, STORE_MAGIC, 4);
+        header.version = STORE_VERSION;
+        header.order = STORE_ORDER;
+        header.capacity = STORE_CAPACITY;
+        st.st_size = sizeof(StoreHeader) + STORE_CAPACITY * sizeof(StoreSlot);
+        if (ftruncate(self->fd, st.st_size) < 0 ||
+            pwrite(self->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            close(self->fd);
+            return false;
+        }
+    }
+    flock(self->fd, LOCK_UN);
+
+    self->size = (size_t)st.st_size;
+    void *data = mmap(NULL, self->size, PROT_READ | PROT_WRITE, MAP_SHARED, self->fd, 0);
+    if (data == MAP_FAILED) {
+        close(self->fd);
+        return false;
+    }
+    self->header = (StoreHeader *)data;
+    self->slots = (StoreSlot *)&self->header[1];
+
+    const StoreHeader *header = self->header;
+    if (self->size < sizeof(StoreHeader) || memcmp(header->magic, STORE_MAGIC, 4) != 0 ||
+        header->version != STORE_VERSION || header->order != STORE_ORDER ||
+        header->capacity == 0 ||
+        self->size != sizeof(StoreHeader) + header->capacity * sizeof(StoreSlot)) {
+        store_close(self);
+        errno = EINVAL;
+        return false;
+    }
+    return true;
+}
+
+// false with errno 0 when the name isn't stored, EBUSY when its slot or
+// one probed before it is stuck mid write
+bool store_get(Store *self, unsigned bits, const char *name, StoreValue *out) noexcept {
+    uint32_t hash = store_hash(bits, name);
+    uint32_t capacity = self->header->capacity;
+    StoreSlot slot;
+    errno = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (!slot_read(&self->slots[(hash + i) % capacity], &slot)) {
+            return false;
+        }
+        if (slot_match(&slot, hash, bits, name)) {
+            out->value = slot.value;
+            out->type = slot.type;
+            out->fmt = slot.fmt;
+            out->floats = slot.floats;
+            return true;
+        }
+    }
+    return false;
+}
+
+// false when the name is too long or the store is full
+bool store_put(Store *self, unsigned bits, const char *name, const StoreValue *value) noexcept {
+    if (strlen(name) >= STORE_NAME) {
+        return false;
+    }
+    uint32_t hash = store_hash(bits, name);
+    uint32_t capacity = self->header->capacity;
+
+    std::lock_guard<std::mutex> lock(store_mutex);
+    flock(self->fd, LOCK_EX);
+    bool stored = false;
+    for (uint32_t i = 0; i < capacity; i++) {
+        StoreSlot *slot = &self->slots[(hash + i) % capacity];
+        uint64_t seq = slot->seq; // only writers change it, and we hold the lock
+        if (seq & 1) {
+            // its writer died holding the lock, the slot may be torn so it
+            // becomes one no name matches, still there for the probes past it
+            slot->bits = 0;
+            seq++;
+            __atomic_store_n(&slot->seq, seq, __ATOMIC_RELEASE);
+        }
+        if (seq != 0 && !slot_match(slot, hash, bits, name)) {
+            continue;
+        }
+
+        __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        if (seq == 0) {
+            slot->hash = hash;
+            slot->bits = (uint8_t)bits;
+            memset(slot->name, 0, sizeof(slot->name));
+            strcpy(slot->name, name);
+        }
+        slot->type = value->type;
+        slot->fmt = value->fmt;
+        slot->floats = value->floats;
+        slot->value = value->value;
+        __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+        stored = true;
+        break;
+    }
+    flock(self->fd, LOCK_UN);
+    return stored;
+}
+
+void store_close(Store *self) noexcept {
+    if (self->header) {
+        munmap(self->header, self->size);
+    }
+    if (self->fd >= 0) {
+        close(self->fd);
+    }
+    memset(self, 0, sizeof(*self));
+    self->fd = -1;
+}
+
+#else
+
+bool store_open(Store *self, const char *path) noexcept {
+    (void)path;
+    memset(self, 0, sizeof(*self));
+    self->fd = -1;
+    errno = ENOSYS;
+    return false;
+}
+
+bool store_get(Store *self, unsigned bits, const char *name, StoreValue *out) noexcept {
+    (void)self; (void)bits; (void)name; (void)out;
+    return false;
+}
+
+bool store_put(Store *self, unsigned bits, const char *name, const StoreValue *value) noexcept {
+    (void)self; (void)bits; (void)name; (void)value;
+    return false;
+}
+
+void store_close(Store *self) noexcept {
+    (void)self;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef HD_STORE_H
+#define HD_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Variables kept in a file across runs, 'hd --store PATH'
+ *
+ * The file is a fixed size open addressing hash table mapped shared by every
+ * hd using it. Readers take no lock, each slot is a seqlock they retry on a
+ * torn read, for a while only as a writer may have died mid write. Writers
+ * are serialized by flock() between processes and a mutex within one, and
+ * mend the slots such a writer left. Entries are keyed by word size and
+ * name, names compare like variables do, without case.
+ */
+
+#define STORE_MAGIC "HDS\x1a"
+#define STORE_VERSION 1
+#define STORE_ORDER 0x01020304u
+#define STORE_CAPACITY 4096 // slots of a new store
+#define STORE_NAME 40 // bytes of a name, with its NUL
+
+struct StoreHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t order;
+    uint32_t capacity;
+    uint64_t reserved[6];
+};
+
+struct StoreSlot {
+    uint64_t seq; // odd while written, 0 for a slot never used
+    uint32_t hash;
+    uint8_t bits; // 0 for a slot its writer died in, matching no name
+    uint8_t type;
+    uint8_t fmt;
+    uint8_t floats; // ImageFloats of the engine that saved it
+    char name[STORE_NAME];
+    uint64_t value;
+};
+
+static_assert(sizeof(StoreHeader) == 64, "store header layout");
+static_assert(sizeof(StoreSlot) == 64, "store slot layout");
+
+// a saved number, its type and format are the engine's Type and Format
+struct StoreValue {
+    uint64_t value;
+    uint8_t type;
+    uint8_t fmt;
+    uint8_t floats;
+};
+
+struct Store {
+    int fd;
+    StoreHeader *header;
+    StoreSlot *slots;
+    size_t size;
+};
+
+bool store_open(Store *self, const char *path) noexcept;
+bool store_get(Store *self, unsigned bits, const char *name, StoreValue *out) noexcept;
+bool store_put(Store *self, unsigned bits, const char *name, const StoreValue *value) noexcept;
+void store_close(Store *self) noexcept;
+
+#endif // HD_STORE_H
@@ -68,6 +68,234 @@ unsigned long lcm(unsigned long a, unsigned long b)
 		return 0;
 }
 
+void mont_init(Montgomery *mont, uint64_t m) noexcept
+{
+	uint64_t inv = m; // right in the low 3 bits for odd m, each step doubles that
+	for (int i = 0; i < 5; i++)
+		inv *= 2 - m * inv;
+	mont->m = m;
+	mont->inv = inv;
+	mont->one = (0 - m) % m;
+	mont->r2 = mulmod(mont->one, mont->one, m);
+}
+
+uint64_t mont_pow(const Montgomery *mont, uint64_t a, uint64_t e) noexcept
+{
+	uint64_t result = mont->one;
+
+	while (e) {
+		if (e & 1)
+			result = mont_mul(mont, result, a);
+		e >>= 1;
+		a = mont_mul(mont, a, a);
+	}
+
+	return result;
+}
+
+uint64_t powmod(uint64_t base, uint64_t e, uint64_t m) noexcept
+{
+	static thread_local Montgomery last = {0, 0, 0, 0};
+	uint64_t result = 1 % m;
+
+	base %= m;
+	if (m & 1) {
+		if (last.m != m)
+			mont_init(&last, m);
+		return mont_from(&last, mont_pow(&last, mont_to(&last, base), e));
+	}
+	while (e) {
+		if (e & 1)
+			result = mulmod(result, base, m);
+		e >>= 1;
+		base = mulmod(base, base, m);
+	}
+
+	return result;
+}
+
+/* Extended Euclid, the coefficients of a kept modulo m */
+bool invmod(uint64_t a, uint64_t m, uint64_t *inv) noexcept
+{
+	uint64_t r0 = m, r1 = a % m;
+	uint64_t t0 = 0, t1 = 1 % m;
+
+	while (r1) {
+		uint64_t q = r0 / r1, r = r0 - q * r1;
+		uint64_t t = addmod(t0, m - mulmod(q % m, t1, m), m);
+		r0 = r1;
+		r1 = r;
+		t0 = t1;
+		t1 = t;
+	}
+	if (r0 != 1)
+		return false;
+	*inv = t0;
+	return true;
+}
+
+static uint64_t gcd64(uint64_t a, uint64_t b) noexcept
+{
+	if (!a || !b)
+		return a | b;
+
+	int shift = __builtin_ctzll(a | b);
+	a >>= __builtin_ctzll(a);
+	while (b) {
+		b >>= __builtin_ctzll(b);
+		if (a > b) {
+			uint64_t t = a;
+			a = b;
+			b = t;
+		}
+		b -= a;
+	}
+
+	return a << shift;
+}
+
+/* n - 1 = d * 2^s, a strong probable prime to base a */
+static bool mr_witness(const Montgomery *mont, uint64_t a, uint64_t d, int s) noexcept
+{
+	uint64_t minus = mont->m - mont->one;
+	uint64_t x = mont_pow(mont, mont_to(mont, a), d);
+
+	if (x == mont->one || x == minus)
+		return true;
+	while (--s > 0) {
+		x = mont_mul(mont, x, x);
+		if (x == minus)
+			return true;
+	}
+
+	return false;
+}
+
+#define SMALL_PRIMES 12
+
+static const uint64_t small_primes[SMALL_PRIMES] = {
+	2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37,
+};
+
+bool is_prime(uint64_t n) noexcept
+{
+	/* these seven bases leave no 64 bit pseudoprime (Sinclair) */
+	static const uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+	if (n < 2)
+		return false;
+	for (int i = 0; i < SMALL_PRIMES; i++) {
+		if (n % small_primes[i] == 0)
+			return n == small_primes[i];
+	}
+	if (n < 37 * 37)
+		return true;
+
+	Montgomery mont;
+	mont_init(&mont, n);
+	int s = __builtin_ctzll(n - 1);
+	uint64_t d = (n - 1) >> s;
+	for (uint64_t a : bases) {
+		if (a % n && !mr_witness(&mont, a % n, d, s))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Pollard's rho with Brent's cycle finding on x^2 + c in Montgomery form,
+ * the differences multiplied up to take a gcd every 128 steps. A factor of
+ * the odd composite n, or n when c was unlucky.
+ */
+static uint64_t rho_brent(uint64_t n, uint64_t c) noexcept
+{
+	const uint64_t m = 128;
+	Montgomery mont;
+	uint64_t x = 0, y = 2, ys = 2, q, g = 1;
+
+	mont_init(&mont, n);
+	q = mont.one;
+	for (uint64_t r = 1; g == 1; r <<= 1) {
+		x = y;
+		for (uint64_t i = 0; i < r; i++)
+			y = addmod(mont_mul(&mont, y, y), c, n);
+		for (uint64_t k = 0; k < r && g == 1; k += m) {
+			ys = y;
+			for (uint64_t i = 0; i < m && i < r - k; i++) {
+				y = addmod(mont_mul(&mont, y, y), c, n);
+				q = mont_mul(&mont, q, x > y ? x - y : y - x);
+			}
+			g = gcd64(q, n);
+		}
+	}
+	/* the batch passed over the factor, step through it again */
+	if (g == n) {
+		do {
+			ys = addmod(mont_mul(&mont, ys, ys), c, n);
+			g = gcd64(x > ys ? x - ys : ys - x, n);
+		} while (g == 1);
+	}
+
+	return g;
+}
+
+/* the factors of n, with no factor below the wheel's bound */
+static unsigned factor_rho(uint64_t n, uint64_t *factors) noexcept
+{
+	if (is_prime(n)) {
+		factors[0] = n;
+		return 1;
+	}
+
+	uint64_t d = n;
+	for (uint64_t c = 1; d == n; c++)
+		d = rho_brent(n, c);
+	unsigned count = factor_rho(d, factors);
+	return count + factor_rho(n / d, factors + count);
+}
+
+#define WHEEL_LIMIT 4096
+
+unsigned factorize(uint64_t n, uint64_t factors[64]) noexcept
+{
+	/* gaps between the numbers prime to 30 from 7 on */
+	static const unsigned char wheel[8] = {4, 2, 4, 2, 4, 6, 2, 6};
+	unsigned count = 0;
+
+	for (int i = 0; i < 3; i++) {
+		uint64_t p = small_primes[i];
+		while (n % p == 0) {
+			factors[count++] = p;
+			n /= p;
+		}
+	}
+	for (uint64_t p = 7, i = 0; p < WHEEL_LIMIT && p * p <= n; p += wheel[i++ & 7]) {
+		while (n % p == 0) {
+			factors[count++] = p;
+			n /= p;
+		}
+	}
+	if (n == 1)
+		return count;
+	if (n < (uint64_t)WHEEL_LIMIT * WHEEL_LIMIT) {
+		factors[count++] = n;
+		return count;
+	}
+
+	unsigned first = count;
+	count += factor_rho(n, factors + count);
+	for (unsigned i = first + 1; i < count; i++) {
+		uint64_t f = factors[i];
+		unsigned j = i;
+		for (; j > first && factors[j - 1] > f; j--)
+			factors[j] = factors[j - 1];
+		factors[j] = f;
+	}
+
+	return count;
+}
+
 void swap(unsigned long *a, unsigned long *b)
 {
 	unsigned long tmp;
@@ -90,56 +318,54 @@ bool is_big_endian(void)
 }
 
 const char *ascii_lookup(int chr) noexcept {
-    static bool firstTime = true;
-    static char buf[4] = {0};
-    static const char *table[128];
-
-    if (firstTime) {
-        firstTime = false;
-        table[0] = "NUL"; // null
-        table[1] = "SOH"; // start of heading
-        table[2] = "STX"; // start of text
-        table[3] = "ETX"; // end of text
-        table[4] = "EOT"; // end of transmission
-        table[5] = "ENQ"; // enquiry
-        table[6] = "ACK"; // acknowledge
-        table[7] = "\\a"; // BEL, ALERT, bell
-        table[8] = "\\b"; // BS, backspace
-        table[9] = "\\t"; // TAB, horizontal tab
-        table[10] = "\\n"; // LF, line feed
-        table[11] = "\\v"; // VT, vertical tab
-        table[12] = "FF"; // NP, form feed, new page
-        table[13] = "\\r"; // CR, carriage return
-        table[14] = "SO"; // shift out
-        table[15] = "SI"; // shift in
-        table[16] = "DLE"; // data link escape
-        table[17] = "DC1"; // device control 1
-        table[18] = "DC2"; // device control 2
-        table[19] = "DC3"; // device control 3
-        table[20] = "DC4"; // device control 4
-        table[21] = "NAK"; // negative acknowledge
-        table[22] = "SYN"; // synchronous idle
-        table[23] = "ETB"; // end of transmission block
-        table[24] = "CAN"; // cancel
-        table[25] = "EM"; // end of medium
-        table[26] = "SUB"; // substitute
-        table[27] = "\\e"; // ESC, escape
-        table[28] = "FS"; // file seperator
-        table[29] = "GS"; // group seperator
-        table[30] = "RS"; // record seperator
-        table[31] = "US"; // unit seperator
-        table[32] = "SPACE"; // space
-        table[127] = "DEL"; // delete
-    }
+    static thread_local char buf[4] = {0};
+    static const char *const table[33] = {
+        "NUL", // null
+        "SOH", // start of heading
+        "STX", // start of text
+        "ETX", // end of text
+        "EOT", // end of transmission
+        "ENQ", // enquiry
+        "ACK", // acknowledge
+        "\\a", // BEL, ALERT, bell
+        "\\b", // BS, backspace
+        "\\t", // TAB, horizontal tab
+        "\\n", // LF, line feed
+        "\\v", // VT, vertical tab
+        "FF", // NP, form feed, new page
+        "\\r", // CR, carriage return
+        "SO", // shift out
+        "SI", // shift in
+        "DLE", // data link escape
+        "DC1", // device control 1
+        "DC2", // device control 2
+        "DC3", // device control 3
+        "DC4", // device control 4
+        "NAK", // negative acknowledge
+        "SYN", // synchronous idle
+        "ETB", // end of transmission block
+        "CAN", // cancel
+        "EM", // end of medium
+        "SUB", // substitute
+        "\\e", // ESC, escape
+        "FS", // file seperator
+        "GS", // group seperator
+        "RS", // record seperator
+        "US", // unit seperator
+        "SPACE", // space
+    };
 
     if (chr < 0 || chr > 255) {
         return "";
     }
 
     // less printable
-    if ((0 <= chr && chr <= 32) || chr == 127) {
+    if (0 <= chr && chr <= 32) {
         return table[chr];
     }
+    if (chr == 127) {
+        return "DEL"; // delete
+    }
 
     // printable
     snprintf(buf, sizeof(buf), "%c", chr);
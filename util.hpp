@@ -1,11 +1,70 @@
 #ifndef HD_MATH_H
 #define HD_MATH_H
 
+#include <stdint.h>
+
 unsigned long long int_pow(unsigned long long base, unsigned int exp);
 unsigned long gcd(unsigned long a, unsigned long b);
 unsigned long lcm(unsigned long a, unsigned long b);
 void swap(unsigned long *a, unsigned long *b);
 
+/**
+ * Arithmetic modulo m, exact for any 64 bit m > 0 through 128 bit products.
+ * Operands are residues, below m.
+ */
+
+static inline uint64_t addmod(uint64_t a, uint64_t b, uint64_t m) noexcept {
+    return a >= m - b ? a - (m - b) : a + b;
+}
+
+static inline uint64_t mulmod(uint64_t a, uint64_t b, uint64_t m) noexcept {
+    return (uint64_t)((unsigned __int128)a * b % m);
+}
+
+/**
+ * Montgomery form for an odd m, x is kept as x * 2^64 mod m so products
+ * reduce with two multiplies instead of a 128 bit division
+ */
+struct Montgomery {
+    uint64_t m;
+    uint64_t inv; // m^-1 mod 2^64
+    uint64_t r2; // 2^128 mod m
+    uint64_t one; // 1 in the form, 2^64 mod m
+};
+
+void mont_init(Montgomery *mont, uint64_t m) noexcept;
+
+// a * b / 2^64 mod m, the product of two values in the form
+static inline uint64_t mont_mul(const Montgomery *mont, uint64_t a, uint64_t b) noexcept {
+    unsigned __int128 t = (unsigned __int128)a * b;
+    uint64_t q = (uint64_t)t * mont->inv; // t - q * m has no low word
+    uint64_t hi = (uint64_t)(t >> 64);
+    uint64_t qm = (uint64_t)(((unsigned __int128)q * mont->m) >> 64);
+    return hi >= qm ? hi - qm : hi - qm + mont->m;
+}
+
+static inline uint64_t mont_to(const Montgomery *mont, uint64_t a) noexcept {
+    return mont_mul(mont, a, mont->r2);
+}
+
+static inline uint64_t mont_from(const Montgomery *mont, uint64_t a) noexcept {
+    return mont_mul(mont, a, 1);
+}
+
+// a^e of a in the form, also in it
+uint64_t mont_pow(const Montgomery *mont, uint64_t a, uint64_t e) noexcept;
+
+// base^e mod m, Montgomery for odd m reusing the last one of the thread
+uint64_t powmod(uint64_t base, uint64_t e, uint64_t m) noexcept;
+// a^-1 mod m into inv, false when gcd(a, m) isn't 1
+bool invmod(uint64_t a, uint64_t m, uint64_t *inv) noexcept;
+
+// deterministic Miller-Rabin, exact for every 64 bit n
+bool is_prime(uint64_t n) noexcept;
+// the prime factors of n > 1 with multiplicity into factors, smallest
+// first, and their count, 64 at most
+unsigned factorize(uint64_t n, uint64_t factors[64]) noexcept;
+
 bool is_little_endian(void);
 bool is_big_endian(void);
 
@@ -0,0 +1,177 @@
+#include "cpu.hpp"
+#include "wide.hpp"
+
+#ifdef CPU_X86
+#  include <immintrin.h>
+#endif
+
+static void and_base(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        out[i] = a[i] & b[i];
+    }
+}
+
+static void or_base(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        out[i] = a[i] | b[i];
+    }
+}
+
+static void xor_base(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        out[i] = a[i] ^ b[i];
+    }
+}
+
+static void clear_base(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        out[i] = a[i] & ~b[i];
+    }
+}
+
+static void inv_base(uint64_t *out, const uint64_t *a, size_t words) noexcept {
+    for (size_t i = 0; i < words; i++) {
+        out[i] = ~a[i];
+    }
+}
+
+static unsigned popcount_base(const uint64_t *a, size_t words) noexcept {
+    unsigned count = 0;
+    for (size_t i = 0; i < words; i++) {
+        count += (unsigned)__builtin_popcountll(a[i]);
+    }
+    return count;
+}
+
+#ifdef CPU_X86
+__attribute__((target("popcnt")))
+static unsigned popcount_popcnt(const uint64_t *a, size_t words) noexcept {
+    unsigned count = 0;
+    for (size_t i = 0; i < words; i++) {
+        count += (unsigned)__builtin_popcountll(a[i]);
+    }
+    return count;
+}
+
+// 4 words a step, the last 3 at most by the base kernel of the operation
+#define WIDE_AVX2(Name, Expr) \
+__attribute__((target("avx2"))) \
+static void Name ## _avx2(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept { \
+    size_t i = 0; \
+    for (; i + 4 <= words; i += 4) { \
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i)); \
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i)); \
+        _mm256_storeu_si256((__m256i *)(out + i), Expr); \
+    } \
+    Name ## _base(out + i, a + i, b + i, words - i); \
+}
+
+WIDE_AVX2(and, _mm256_and_si256(x, y))
+WIDE_AVX2(or, _mm256_or_si256(x, y))
+WIDE_AVX2(xor, _mm256_xor_si256(x, y))
+WIDE_AVX2(clear, _mm256_andnot_si256(y, x))
+#undef WIDE_AVX2
+
+__attribute__((target("avx2")))
+static void inv_avx2(uint64_t *out, const uint64_t *a, size_t words) noexcept {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_xor_si256(x, ones));
+    }
+    inv_base(out + i, a + i, words - i);
+}
+
+// the bits of each nibble by a table lookup, summed per word by sad (Mula)
+__attribute__((target("avx2,popcnt")))
+static unsigned popcount_avx2(const uint64_t *a, size_t words) noexcept {
+    const __m256i table = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, low));
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    unsigned count = (unsigned)(_mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) +
+        _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3));
+    for (; i < words; i++) {
+        count += (unsigned)__builtin_popcountll(a[i]);
+    }
+    return count;
+}
+
+// 8 words a step, the last masked to the words left
+#define WIDE_AVX512(Name, Expr) \
+__attribute__((target("avx512f,avx512bw"))) \
+static void Name ## _avx512(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words) noexcept { \
+    for (size_t i = 0; i < words; i += 8) { \
+        __mmask8 m = words - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (words - i)) - 1); \
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i); \
+        __m512i y = _mm512_maskz_loadu_epi64(m, b + i); \
+        _mm512_mask_storeu_epi64(out + i, m, Expr); \
+    } \
+}
+
+WIDE_AVX512(and, _mm512_and_si512(x, y))
+WIDE_AVX512(or, _mm512_or_si512(x, y))
+WIDE_AVX512(xor, _mm512_xor_si512(x, y))
+WIDE_AVX512(clear, _mm512_maskz_andnot_epi64(0xFF, y, x))
+#undef WIDE_AVX512
+
+__attribute__((target("avx512f,avx512bw")))
+static void inv_avx512(uint64_t *out, const uint64_t *a, size_t words) noexcept {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    for (size_t i = 0; i < words; i += 8) {
+        __mmask8 m = words - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (words - i)) - 1);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        _mm512_mask_storeu_epi64(out + i, m, _mm512_xor_si512(x, ones));
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static unsigned popcount_avx512(const uint64_t *a, size_t words) noexcept {
+    const __m512i table = _mm512_set_epi64( // the bytes of the AVX2 table, 4 times
+        0x0403030203020201, 0x0302020102010100, 0x0403030203020201, 0x0302020102010100,
+        0x0403030203020201, 0x0302020102010100, 0x0403030203020201, 0x0302020102010100);
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i sum = _mm512_setzero_si512();
+    for (size_t i = 0; i < words; i += 8) {
+        __mmask8 m = words - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (words - i)) - 1);
+        __m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+        __m512i lo = _mm512_shuffle_epi8(table, _mm512_and_si512(x, low));
+        __m512i hi = _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(x, 4), low));
+        sum = _mm512_add_epi64(sum, _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512()));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, sum);
+    return (unsigned)(lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7]);
+}
+#endif
+
+WideKernels wide_kernels(unsigned features) noexcept {
+    WideKernels kernels = {
+        and_base, or_base, xor_base, clear_base, inv_base, popcount_base,
+        "base",
+    };
+#ifdef CPU_X86
+    if (features & CPU_POPCNT) {
+        kernels.popcount = popcount_popcnt;
+        kernels.name = "popcnt";
+    }
+    if ((features & CPU_AVX2) && (features & CPU_POPCNT)) {
+        kernels = {and_avx2, or_avx2, xor_avx2, clear_avx2, inv_avx2, popcount_avx2, "avx2"};
+    }
+    if (features & CPU_AVX512BW) {
+        kernels = {and_avx512, or_avx512, xor_avx512, clear_avx512, inv_avx512, popcount_avx512, "avx512bw"};
+    }
+#else
+    (void)features;
+#endif
+    return kernels;
+}
@@ -0,0 +1,30 @@
+#ifndef HD_WIDE_H
+#define HD_WIDE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bitwise kernels of the bit vectors of 'hd --wide', arrays of 64 bit words
+ * least significant first, in variants for the extensions of cpu_features().
+ * AVX2 takes 4 words a step and AVX-512 8, its last step masked. out may be
+ * one of the operands.
+ */
+
+#define WIDE_MAX_BITS 4096
+#define WIDE_MAX_WORDS (WIDE_MAX_BITS / 64)
+
+struct WideKernels {
+    void (* bit_and)(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+    void (* bit_or)(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+    void (* bit_xor)(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+    void (* bit_clear)(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words); // a & ~b
+    void (* inv)(uint64_t *out, const uint64_t *a, size_t words);
+    unsigned (* popcount)(const uint64_t *a, size_t words);
+    const char *name;
+};
+
+// the fastest variants for features, a mask of CpuFeature
+WideKernels wide_kernels(unsigned features) noexcept;
+
+#endif // HD_WIDE_H